@@ -0,0 +1,365 @@
+// Micro-benchmarks for the loading and analytics hot paths.
+//
+// Links the orderbook_core library and generates its books with generateCSV.
+//
+//   ./bench                         # 10, 1k, 100k and 10M levels per side
+//   ./bench --levels 10,1000        # a subset
+//   ./bench --min-time 0.5          # seconds spent per measurement (default 0.2)
+//   ./bench --verify                # checks the cost queries against level walks instead
+
+#include "orderbook/calc.h"
+#include "orderbook/consolidated.h"
+#include "orderbook/cost.h"
+#include "orderbook/fixed.h"
+#include "orderbook/generate.h"
+#include "orderbook/load.h"
+#include "orderbook/parse.h"
+#include "orderbook/query.h"
+#include "orderbook/simd.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+namespace {
+
+volatile double benchSink = 0.0;  // defeats dead-code elimination of results
+
+struct BenchResult {
+    double nsPerOp;
+    double itemsPerSec;
+};
+
+// Runs `op` in batches, doubling the batch until one lasts at least `minSeconds`, so the
+// clock is read once per batch rather than once per call; `items` is the work per call
+template <typename Fn>
+BenchResult measure(double minSeconds, double items, Fn&& op) {
+    using Clock = std::chrono::steady_clock;
+    for (size_t batch = 1;; batch *= 2) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < batch; i++) op();
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (elapsed < minSeconds) continue;
+
+        double perOp = elapsed / static_cast<double>(batch);
+        return {perOp * 1e9, items / perOp};
+    }
+}
+
+void report(const char* name, int levels, const char* unit, const BenchResult& r) {
+    std::printf("%-28s %10d %14.1f ns/op %16.0f %s\n", name, levels, r.nsPerOp, r.itemsPerSec, unit);
+}
+
+std::vector<std::string> readDataLines(const std::string& filename) {
+    std::ifstream file(filename);
+    std::vector<std::string> lines;
+    std::string line;
+    std::getline(file, line); // header
+    while (std::getline(file, line)) lines.push_back(line);
+    return lines;
+}
+
+void benchLevels(int levels, double minSeconds, const std::filesystem::path& dir) {
+    GeneratorConfig cfg;
+    cfg.levels   = levels;
+    cfg.midPrice = 100.0 + 2.0 * levels * cfg.tickSize; // keeps every bid price positive
+    cfg.filename = (dir / ("bench_" + std::to_string(levels) + ".csv")).string();
+    generateCSV(cfg);
+
+    const double rows = 2.0 * levels;
+
+    report("loadCSV", levels, "rows/s", measure(minSeconds, rows, [&] {
+        benchSink = loadCSV(cfg.filename).bids[0].price;
+    }));
+    report("loadCSVMapped", levels, "rows/s", measure(minSeconds, rows, [&] {
+        benchSink = loadCSVMapped(cfg.filename).bids[0].price;
+    }));
+    Orderbook   reused;
+    LoadBuffers buffers;
+    report("loadCSVMapped (reused)", levels, "rows/s", measure(minSeconds, rows, [&] {
+        loadCSVParallel(cfg.filename, 1, {}, reused, buffers);
+        benchSink = reused.bids[0].price;
+    }));
+    report("loadCSVParallel (all cores)", levels, "rows/s", measure(minSeconds, rows, [&] {
+        benchSink = loadCSVParallel(cfg.filename, 0).bids[0].price;
+    }));
+
+    std::vector<std::string> lines = readDataLines(cfg.filename);
+    report("parseRow", levels, "rows/s", measure(minSeconds, rows, [&] {
+        double total = 0.0;
+        for (size_t i = 0; i < lines.size(); i++) total += parseRow(lines[i], static_cast<int>(i + 2)).size;
+        benchSink = total;
+    }));
+
+    Orderbook book = loadCSVMapped(cfg.filename);
+    SoABook   soa  = toSoA(book);
+    double mid   = (book.bids[0].price + book.asks[0].price) / 2.0;
+    double lower = mid * (1.0 - 0.5 / 100.0);
+    double upper = mid * (1.0 + 0.5 / 100.0);
+    double qty   = soa.asks.cumSize.back() / 2.0; // walks half of each side
+
+    report("calcDepth (AoS)", levels, "queries/s", measure(minSeconds, 1, [&] {
+        benchSink = calcDepth(book.bids, lower, upper);
+    }));
+    for (const auto& kernels : availableKernels()) {
+        selectKernels(kernels.name);
+        std::string depthName = std::string("calcDepth (SoA ") + kernels.name + ")";
+        report(depthName.c_str(), levels, "queries/s", measure(minSeconds, 1, [&] {
+            benchSink = calcDepth(soa.bids, lower, upper);
+        }));
+        std::string vwapName = std::string("calcVWAPBuy (SoA ") + kernels.name + ")";
+        report(vwapName.c_str(), levels, "queries/s", measure(minSeconds, 1, [&] {
+            benchSink = calcVWAPBuy(soa.asks, qty);
+        }));
+    }
+    selectKernels("auto");
+    report("calcDepthIndexed", levels, "queries/s", measure(minSeconds, 1, [&] {
+        benchSink = calcDepthIndexed<Side::BID>(soa.bids, lower, upper);
+    }));
+    report("calcVWAPBuy (AoS)", levels, "queries/s", measure(minSeconds, 1, [&] {
+        benchSink = calcVWAPBuy(book.asks, qty);
+    }));
+    report("calcVWAPSell (AoS)", levels, "queries/s", measure(minSeconds, 1, [&] {
+        benchSink = calcVWAPSell(book.bids, qty);
+    }));
+    report("toSoA", levels, "rows/s", measure(minSeconds, rows, [&] {
+        toSoA(book, soa);
+        benchSink = soa.bids.cumSize.back();
+    }));
+    report("calcStats (SoA)", levels, "queries/s", measure(minSeconds, 1, [&] {
+        benchSink = calcStats(soa, 0.5, qty).vwapBuy;
+    }));
+
+    report("queryStats (span)", levels, "queries/s", measure(minSeconds, 1, [&] {
+        Stats s;
+        queryStats(viewOf(book), 0.5, qty, s);
+        benchSink = s.vwapBuy;
+    }));
+
+    report("costForQty", levels, "queries/s", measure(minSeconds, 1, [&] {
+        benchSink = costForQty(soa.asks, qty).vwap;
+    }));
+    report("maxQtyWithin (25 bps)", levels, "queries/s", measure(minSeconds, 1, [&] {
+        benchSink = maxQtyWithin<Side::ASK>(soa.asks, mid, 25.0);
+    }));
+    report("costToReach", levels, "queries/s", measure(minSeconds, 1, [&] {
+        benchSink = costToReach<Side::ASK>(soa.asks, upper).notional;
+    }));
+
+    FixedBook fixed    = toFixed(book, cfg.tickSize, 0.0);
+    double    fixedQty = std::floor(qty / fixed.lotSize) * fixed.lotSize;
+    report("calcStatsFixed", levels, "queries/s", measure(minSeconds, 1, [&] {
+        benchSink = calcStatsFixed(fixed, 0.5, fixedQty).vwapBuy;
+    }));
+
+    // The same levels dealt round-robin across 20 venues, so the merged book is `levels` deep
+    constexpr uint32_t VENUES = 20;
+    std::vector<Orderbook> venues(VENUES);
+    ConsolidatedBook       consolidated;
+    for (uint32_t v = 0; v < VENUES; v++) consolidated.addVenue("venue" + std::to_string(v));
+    for (size_t i = 0; i < book.bids.size(); i++) venues[i % VENUES].bids.push_back(book.bids[i]);
+    for (size_t i = 0; i < book.asks.size(); i++) venues[i % VENUES].asks.push_back(book.asks[i]);
+    report("consolidated build (20)", levels, "rows/s", measure(minSeconds, rows, [&] {
+        consolidated.build(venues);
+        benchSink = consolidated.bids()[0].price;
+    }));
+    LevelUpdate touch{Side::ASK, book.asks[0].price, book.asks[0].size};
+    report("consolidated apply", levels, "updates/s", measure(minSeconds, 2, [&] {
+        touch.size = 0.0;
+        consolidated.apply(0, touch);  // remove the best ask, then put it back
+        touch.size = book.asks[0].size;
+        consolidated.apply(0, touch);
+        benchSink = consolidated.asks()[0].size;
+    }));
+    report("consolidated stats", levels, "queries/s", measure(minSeconds, 1, [&] {
+        benchSink = consolidated.stats(qty).vwapBuy;
+    }));
+
+    std::filesystem::remove(cfg.filename);
+    std::printf("\n");
+}
+
+// ---- Cost-query verification ---------------------------------------------------
+//
+// costForQty, maxQtyWithin and costToReach answer from the prefix arrays by binary
+// search; the references below walk the levels one by one instead.
+
+// Fill of `qty` walking `side` level by level
+CostPoint walkCost(const BookSide& side, double qty) {
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+    if (!(qty > 0.0)) return {0.0, 0.0, NaN, true};
+    double filled = 0.0, notional = 0.0;
+    for (size_t i = 0; i < side.size() && filled < qty; i++) {
+        double take = std::min(side.sizes[i], qty - filled);
+        filled   += take;
+        notional += take * side.prices[i];
+    }
+    bool complete = filled >= qty;
+    return {filled, notional, filled > 0.0 ? notional / filled : NaN, complete};
+}
+
+// Largest qty whose walked VWAP is within bps of refPrice, by bisection over the fill
+template <Side S>
+double bisectMaxQty(const BookSide& side, double refPrice, double bps) {
+    double limit  = SideTraits<S>::isBid ? refPrice * (1.0 - bps / 1e4) : refPrice * (1.0 + bps / 1e4);
+    auto   within = [&](double qty) {
+        double vwap = walkCost(side, qty).vwap;
+        return SideTraits<S>::isBid ? vwap >= limit : vwap <= limit;
+    };
+    double total = side.cumSize.back();
+    if (within(total)) return total;
+    double lo = 0.0, hi = total;
+    for (int i = 0; i < 200 && hi - lo > 0.0; i++) {
+        double mid = (lo + hi) / 2.0;
+        if (mid <= lo || mid >= hi) break;
+        (within(mid) ? lo : hi) = mid;
+    }
+    return lo;
+}
+
+// Every level strictly better than `price`, summed one by one
+template <Side S>
+CostPoint walkToReach(const BookSide& side, double price) {
+    double qty = 0.0, notional = 0.0;
+    size_t taken = 0;
+    for (; taken < side.size() && SideTraits<S>::better(side.prices[taken], price); taken++) {
+        qty      += side.sizes[taken];
+        notional += side.sizes[taken] * side.prices[taken];
+    }
+    return {qty, notional, qty > 0.0 ? notional / qty : std::numeric_limits<double>::quiet_NaN(),
+            taken < side.size()};
+}
+
+class CostVerifier {
+public:
+    // Compares `got` to `want` to a relative `tolerance`, printing the first mismatches
+    void check(const std::string& what, double got, double want, double tolerance = 1e-9) {
+        checks_++;
+        bool equal = (std::isnan(got) && std::isnan(want)) ||
+                     std::abs(got - want) <= tolerance * std::max({1.0, std::abs(got), std::abs(want)});
+        if (equal) return;
+        if (++failures_ <= 20) std::printf("  MISMATCH %s: got %.17g, expected %.17g\n", what.c_str(), got, want);
+    }
+
+    void check(const std::string& what, const CostPoint& got, const CostPoint& want) {
+        check(what + " qty",      got.qty,      want.qty);
+        check(what + " notional", got.notional, want.notional);
+        check(what + " vwap",     got.vwap,     want.vwap);
+        check(what + " complete", got.complete, want.complete, 0.0);
+    }
+
+    template <Side S>
+    void verifySide(const BookSide& side, double mid, const std::string& name) {
+        // Fill sizes: none, negative, every cumulative boundary and the middle of every
+        // level, exactly the whole side and beyond it
+        std::vector<double> quantities = {0.0, -1.0, side.cumSize.back(), side.cumSize.back() * 1.5};
+        for (size_t k = 1; k < side.cumSize.size(); k++) {
+            quantities.push_back(side.cumSize[k]);
+            quantities.push_back((side.cumSize[k - 1] + side.cumSize[k]) / 2.0);
+        }
+        for (double qty : quantities)
+            check(name + " costForQty(" + std::to_string(qty) + ")", costForQty(side, qty), walkCost(side, qty));
+
+        // Limits at or below zero, inside the book and past its last level
+        for (double bps : {-50.0, -1.0, 0.0, 0.01, 0.5, 1.0, 5.0, 25.0, 100.0, 1000.0, 1e4}) {
+            double got  = maxQtyWithin<S>(side, mid, bps);
+            double want = bisectMaxQty<S>(side, mid, bps);
+            // Looser: where a level price equals the limit, rounding in the walked VWAP
+            // stops the bisection a hair short of the level boundary
+            check(name + " maxQtyWithin(" + std::to_string(bps) + " bps)", got, want, 1e-8);
+        }
+
+        // Targets: on every level, between levels, at the touch and past the last level
+        double step = side.size() > 1 ? std::abs(side.prices[1] - side.prices[0]) : 1.0;
+        double away = SideTraits<S>::isBid ? -1.0 : 1.0;  // direction of worse prices
+        std::vector<double> prices = {side.prices.back() + away * step, side.prices.back() + away * 100.0 * step,
+                                      side.prices[0] - away * step};
+        for (size_t k = 0; k < side.size(); k++) {
+            prices.push_back(side.prices[k]);
+            prices.push_back(side.prices[k] + away * step / 2.0);
+        }
+        for (double price : prices)
+            check(name + " costToReach(" + std::to_string(price) + ")",
+                  costToReach<S>(side, price), walkToReach<S>(side, price));
+    }
+
+    size_t checks()   const { return checks_; }
+    size_t failures() const { return failures_; }
+
+private:
+    size_t checks_   = 0;
+    size_t failures_ = 0;
+};
+
+// Random books from 1 to 200 levels per side, with integer, decimal and tiny sizes
+int verifyCostQueries() {
+    std::mt19937_64 rng(42);
+    CostVerifier    verifier;
+    for (int round = 0; round < 500; round++) {
+        size_t levels = 1 + rng() % 200;
+        double tick   = round % 3 == 0 ? 1.0 : 0.01;
+        double mid    = 1000.0;
+        auto   size   = [&]() -> double {
+            switch (round % 3) {
+            case 0:  return static_cast<double>(1 + rng() % 100);
+            case 1:  return static_cast<double>(1 + rng() % 100000) / 1000.0;
+            default: return static_cast<double>(1 + rng() % 1000) * 1e-6;
+            }
+        };
+
+        Orderbook book;
+        double gap = tick * static_cast<double>(1 + rng() % 3);
+        for (size_t i = 0; i < levels; i++) {
+            double offset = gap / 2.0 + tick * static_cast<double>(i) * static_cast<double>(1 + rng() % 2);
+            book.bids.push_back({Side::BID, mid - offset, size()});
+            book.asks.push_back({Side::ASK, mid + offset, size()});
+        }
+        for (auto* side : {&book.bids, &book.asks}) {
+            std::sort(side->begin(), side->end(), [](const Order& a, const Order& b) { return a.price < b.price; });
+            side->erase(std::unique(side->begin(), side->end(),
+                                    [](const Order& a, const Order& b) { return a.price == b.price; }),
+                        side->end());
+        }
+        std::reverse(book.bids.begin(), book.bids.end());  // best first
+
+        SoABook soa = toSoA(book);
+        std::string name = "book " + std::to_string(round);
+        verifier.verifySide<Side::ASK>(soa.asks, mid, name + " asks");
+        verifier.verifySide<Side::BID>(soa.bids, mid, name + " bids");
+    }
+
+    std::printf("cost queries: %zu checks, %zu mismatches\n", verifier.checks(), verifier.failures());
+    return verifier.failures() == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<double> levels = {10, 1000, 100000, 10000000};
+    double minSeconds = 0.2;
+    bool   verify     = false;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if      (arg == "--levels"   && i + 1 < argc) levels     = parseDoubleList(argv[++i], "levels");
+            else if (arg == "--min-time" && i + 1 < argc) minSeconds = std::stod(argv[++i]);
+            else if (arg == "--verify")                   verify     = true;
+            else throw std::invalid_argument("Unknown argument: '" + arg + "'");
+        }
+
+        if (verify) return verifyCostQueries();
+
+        std::filesystem::path dir = std::filesystem::temp_directory_path();
+        std::printf("%-28s %10s %20s %23s\n", "benchmark", "levels", "time", "throughput");
+        for (double n : levels) benchLevels(static_cast<int>(n), minSeconds, dir);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "\n[ERROR] " << e.what() << "\n\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,390 @@
+// Scaling harness: drives the built generate_orderbook and orderbook binaries over
+// growing books, input formats and thread counts, and writes one CSV row per case
+// with latency percentiles, throughput and peak RSS. Rows from two runs (e.g. two
+// commits) are compared by case with --compare.
+//
+//   ./scale                                        # 10 .. 10M levels, every format
+//   ./scale --levels 1e6,1e8 --threads 1,4,16      # 1e8: ~8 GB temp space, ~11 GB RAM
+//   ./scale --formats mmap,serve --label abc123 --out abc123.csv
+//   ./scale --compare base.csv abc123.csv          # per-case change, regressions marked
+//
+// Formats: csv (loadCSV), mmap (--threads T, once per thread count), binary (.obk
+// snapshot), serve (STATS round trips to --serve with the book resident) and
+// generate (the generator itself). Every load case is a fresh process, so its
+// latency includes startup, parsing, sorting and analysis, and its peak RSS is the
+// whole process's. Throughput is levels (both sides) per second at the median, or
+// queries per second for serve.
+
+#include "orderbook/parse.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct ScaleConfig {
+    std::vector<double>      levels   = {10, 1000, 100000, 1000000, 10000000};
+    std::vector<double>      threads  = {1, static_cast<double>(std::max(1u, std::thread::hardware_concurrency()))};
+    std::vector<std::string> formats  = {"generate", "csv", "mmap", "binary", "serve"};
+    int                      runs     = 5;      // processes per load case
+    int                      queries  = 20000;  // round trips per serve case
+    std::string              label    = "current";
+    std::string              out      = "scale_results.csv";
+    std::filesystem::path    binDir;            // where orderbook / generate_orderbook live
+    std::filesystem::path    dataDir  = std::filesystem::temp_directory_path();
+};
+
+// One result row
+struct ScaleRow {
+    std::string label;
+    std::string format;
+    long long   levels;
+    int         threads;
+    int         samples;
+    double      p50Us, p90Us, p99Us;
+    double      throughput;  // levels/s, or queries/s for serve
+    double      peakRssMb;
+};
+
+const char* RESULT_HEADER = "label,format,levels,threads,samples,p50_us,p90_us,p99_us,throughput,peak_rss_mb";
+
+struct ProcessResult {
+    double seconds;
+    double peakRssMb;
+};
+
+// Starts `args` with stdout (and, when `quiet`, stderr) discarded
+pid_t spawn(const std::vector<std::string>& args, bool quiet = false) {
+    std::vector<char*> argv;
+    for (const auto& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    if (quiet) posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+    pid_t pid;
+    int   rc = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (rc != 0) throw std::runtime_error("Cannot run '" + args[0] + "': " + std::strerror(rc));
+    return pid;
+}
+
+// Waits for a spawned process; throws on a non-zero exit
+ProcessResult wait(pid_t pid, const std::string& what, Clock::time_point start) {
+    int    status;
+    rusage usage;
+    if (::wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        throw std::runtime_error("'" + what + "' failed");
+    return {std::chrono::duration<double>(Clock::now() - start).count(), usage.ru_maxrss / 1024.0};
+}
+
+ProcessResult run(const std::vector<std::string>& args) {
+    auto start = Clock::now();
+    return wait(spawn(args), args[0], start);
+}
+
+// Nearest-rank percentile of ascending samples
+double percentile(const std::vector<double>& sorted, double pct) {
+    size_t rank = static_cast<size_t>(std::ceil(pct / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+ScaleRow summarize(const ScaleConfig& cfg, const std::string& format, long long levels, int threads,
+                   std::vector<double> seconds, double items, double peakRssMb) {
+    std::sort(seconds.begin(), seconds.end());
+    double median = percentile(seconds, 50);
+    return {cfg.label, format, levels, threads, static_cast<int>(seconds.size()),
+            median * 1e6, percentile(seconds, 90) * 1e6, percentile(seconds, 99) * 1e6,
+            items / median, peakRssMb};
+}
+
+void print(const ScaleRow& r) {
+    std::printf("%-9s %11lld %7d %12.1f %12.1f %12.1f %14.0f %10.1f\n", r.format.c_str(), r.levels, r.threads,
+                r.p50Us, r.p90Us, r.p99Us, r.throughput, r.peakRssMb);
+    std::fflush(stdout);
+}
+
+// Runs `args` cfg.runs times as independent processes
+ScaleRow measureLoad(const ScaleConfig& cfg, const std::string& format, long long levels, int threads,
+                     const std::vector<std::string>& args) {
+    std::vector<double> seconds;
+    double peak = 0.0;
+    for (int i = 0; i < cfg.runs; i++) {
+        ProcessResult r = run(args);
+        seconds.push_back(r.seconds);
+        peak = std::max(peak, r.peakRssMb);
+    }
+    return summarize(cfg, format, levels, threads, std::move(seconds), 2.0 * levels, peak);
+}
+
+int connectUnix(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return fd;
+    if (fd >= 0) ::close(fd);
+    return -1;
+}
+
+// Sends one request line and returns its reply line
+std::string roundTrip(int fd, const std::string& request) {
+    if (::send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size()))
+        throw std::runtime_error("Server connection lost");
+    std::string reply;
+    char        buffer[4096];
+    while (reply.empty() || reply.back() != '\n') {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) throw std::runtime_error("Server connection lost");
+        reply.append(buffer, static_cast<size_t>(n));
+    }
+    return reply;
+}
+
+// Owns a spawned --serve child and its connection until release(): on an early
+// return or exception the child is sent SIGTERM and reaped, and its socket removed
+struct ServerGuard {
+    pid_t       pid = -1;
+    int         fd  = -1;
+    std::string socket;
+
+    ServerGuard(pid_t p, std::string path) : pid(p), socket(std::move(path)) {}
+    ServerGuard(const ServerGuard&)            = delete;
+    ServerGuard& operator=(const ServerGuard&) = delete;
+    ~ServerGuard() {
+        if (fd >= 0) ::close(fd);
+        if (pid > 0) {
+            ::kill(pid, SIGTERM);
+            int status;
+            ::waitpid(pid, &status, 0);
+        }
+        std::error_code ec;
+        std::filesystem::remove(socket, ec);
+    }
+
+    pid_t release() {
+        pid_t p = pid;
+        pid     = -1;
+        return p;
+    }
+};
+
+// Starts --serve with the book preloaded, times STATS round trips one at a time,
+// then shuts the server down; peak RSS is the server's, book included
+ScaleRow measureServe(const ScaleConfig& cfg, const std::string& orderbook, const std::string& csv,
+                      long long levels) {
+    std::string socket = (cfg.dataDir / ("scale_" + std::to_string(::getpid()) + ".sock")).string();
+    auto  start = Clock::now();
+    ServerGuard server(spawn({orderbook, "--serve", socket, "--mmap", csv}, true), socket);
+
+    while ((server.fd = connectUnix(socket)) < 0) {
+        int status;
+        if (::waitpid(server.pid, &status, WNOHANG) == server.pid) {
+            server.release();  // already reaped
+            throw std::runtime_error("Server exited during startup");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    int         fd   = server.fd;
+    std::string book = std::filesystem::path(csv).stem().string();
+    if (roundTrip(fd, "PING\n").rfind("OK", 0) != 0) throw std::runtime_error("Server did not answer PING");
+
+    std::vector<double> seconds;
+    seconds.reserve(cfg.queries);
+    for (int i = 0; i < cfg.queries; i++) {
+        std::string request = "STATS " + book + " 0.5 " + std::to_string(40 * (1 + i % 16)) + "\n";
+        auto        sent    = Clock::now();
+        std::string reply   = roundTrip(fd, request);
+        seconds.push_back(std::chrono::duration<double>(Clock::now() - sent).count());
+        if (reply.rfind("OK", 0) != 0) throw std::runtime_error("Query failed: " + reply);
+    }
+    double total = 0.0;
+    for (double s : seconds) total += s;
+
+    roundTrip(fd, "SHUTDOWN\n");
+    ::close(fd);
+    server.fd = -1;
+    ProcessResult served = wait(server.release(), orderbook + " --serve", start);
+
+    ScaleRow row = summarize(cfg, "serve", levels, 1, std::move(seconds), 0.0, served.peakRssMb);
+    row.throughput = cfg.queries / total;
+    return row;
+}
+
+bool wants(const ScaleConfig& cfg, const std::string& format) {
+    return std::find(cfg.formats.begin(), cfg.formats.end(), format) != cfg.formats.end();
+}
+
+void scaleLevels(const ScaleConfig& cfg, long long levels, std::vector<ScaleRow>& rows) {
+    std::string orderbook = (cfg.binDir / "orderbook").string();
+    std::string generator = (cfg.binDir / "generate_orderbook").string();
+    std::string stem      = (cfg.dataDir / ("scale_" + std::to_string(levels))).string();
+    std::string csv = stem + ".csv", obk = stem + ".obk";
+    std::string mid = std::to_string(100.0 + 2.0 * levels * 0.10);  // the generator's tick; keeps bids positive
+
+    auto record = [&](ScaleRow row) {
+        print(row);
+        rows.push_back(std::move(row));
+    };
+
+    ProcessResult generated = run({generator, csv, std::to_string(levels), mid});
+    if (wants(cfg, "generate"))
+        record(summarize(cfg, "generate", levels, 0, {generated.seconds}, 2.0 * levels, generated.peakRssMb));
+
+    if (wants(cfg, "csv")) record(measureLoad(cfg, "csv", levels, 1, {orderbook, csv}));
+    if (wants(cfg, "mmap")) {
+        for (double t : cfg.threads) {
+            int threads = static_cast<int>(t);
+            record(measureLoad(cfg, "mmap", levels, threads, {orderbook, "--threads", std::to_string(threads), csv}));
+        }
+    }
+    if (wants(cfg, "binary")) {
+        run({generator, obk, std::to_string(levels), mid});
+        record(measureLoad(cfg, "binary", levels, 1, {orderbook, obk}));
+        std::filesystem::remove(obk);
+    }
+    if (wants(cfg, "serve")) record(measureServe(cfg, orderbook, csv, levels));
+    std::filesystem::remove(csv);
+}
+
+void writeResults(const std::string& filename, const std::vector<ScaleRow>& rows) {
+    std::ofstream file(filename);
+    if (!file.is_open()) throw std::runtime_error("Cannot write '" + filename + "'");
+    file << RESULT_HEADER << "\n";
+    for (const ScaleRow& r : rows)
+        file << r.label << "," << r.format << "," << r.levels << "," << r.threads << "," << r.samples << ","
+             << r.p50Us << "," << r.p90Us << "," << r.p99Us << "," << r.throughput << "," << r.peakRssMb << "\n";
+}
+
+std::vector<ScaleRow> readResults(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) throw std::runtime_error("Cannot open file: '" + filename + "'");
+    std::string line;
+    if (!std::getline(file, line) || line != RESULT_HEADER)
+        throw std::runtime_error("Not a scale results file: '" + filename + "'");
+
+    std::vector<ScaleRow> rows;
+    while (std::getline(file, line)) {
+        std::string_view rest = line;
+        ScaleRow r;
+        r.label      = std::string(nextField(rest));
+        r.format     = std::string(nextField(rest));
+        r.levels     = std::stoll(std::string(nextField(rest)));
+        r.threads    = std::stoi(std::string(nextField(rest)));
+        r.samples    = std::stoi(std::string(nextField(rest)));
+        r.p50Us      = parseDouble(nextField(rest), "p50_us", true);
+        r.p90Us      = parseDouble(nextField(rest), "p90_us", true);
+        r.p99Us      = parseDouble(nextField(rest), "p99_us", true);
+        r.throughput = parseDouble(nextField(rest), "throughput", true);
+        r.peakRssMb  = parseDouble(nextField(rest), "peak_rss_mb", true);
+        rows.push_back(std::move(r));
+    }
+    return rows;
+}
+
+// Matches cases by (format, levels, threads) and prints the relative change of each
+// metric; a case whose throughput drops or whose p50 or peak RSS grows by more than
+// `threshold` percent is marked. Returns the number of marked cases.
+int compareResults(const std::string& baseFile, const std::string& newFile, double threshold) {
+    using Key = std::tuple<std::string, long long, int>;
+    std::map<Key, ScaleRow> base;
+    for (ScaleRow& r : readResults(baseFile)) base[{r.format, r.levels, r.threads}] = std::move(r);
+
+    auto change = [](double before, double after) { return before > 0.0 ? (after / before - 1.0) * 100.0 : 0.0; };
+    int  marked = 0;
+    std::printf("%-9s %11s %7s %14s %14s %9s %9s %9s\n", "format", "levels", "threads",
+                "base", "new", "thru %", "p50 %", "rss %");
+    for (const ScaleRow& r : readResults(newFile)) {
+        auto it = base.find({r.format, r.levels, r.threads});
+        if (it == base.end()) continue;
+        const ScaleRow& b = it->second;
+        double thru = change(b.throughput, r.throughput);
+        double p50  = change(b.p50Us, r.p50Us);
+        double rss  = change(b.peakRssMb, r.peakRssMb);
+        bool   worse = thru < -threshold || p50 > threshold || rss > threshold;
+        marked += worse;
+        std::printf("%-9s %11lld %7d %14.0f %14.0f %+9.1f %+9.1f %+9.1f%s\n", r.format.c_str(), r.levels,
+                    r.threads, b.throughput, r.throughput, thru, p50, rss, worse ? "  <- regression" : "");
+    }
+    return marked;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ScaleConfig cfg;
+    cfg.binDir = std::filesystem::canonical("/proc/self/exe").parent_path();
+    std::vector<std::string> compare;
+    double threshold = 10.0;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg + ".");
+                return argv[++i];
+            };
+            if      (arg == "--levels")    cfg.levels  = parseDoubleList(value(), "levels");
+            else if (arg == "--threads")   cfg.threads = parseDoubleList(value(), "threads");
+            else if (arg == "--runs")      cfg.runs    = std::max(1, std::stoi(value()));
+            else if (arg == "--queries")   cfg.queries = std::max(1, std::stoi(value()));
+            else if (arg == "--label")     cfg.label   = value();
+            else if (arg == "--out")       cfg.out     = value();
+            else if (arg == "--bin-dir")   cfg.binDir  = value();
+            else if (arg == "--data-dir")  cfg.dataDir = value();
+            else if (arg == "--threshold") threshold   = parseDouble(value(), "threshold");
+            else if (arg == "--formats") {
+                cfg.formats.clear();
+                std::string_view rest = value();
+                while (!rest.empty()) cfg.formats.emplace_back(nextField(rest));
+            }
+            else if (arg == "--compare")   { compare.push_back(value()); compare.push_back(value()); }
+            else throw std::invalid_argument("Unknown argument: '" + arg + "'");
+        }
+
+        std::sort(cfg.threads.begin(), cfg.threads.end());
+        cfg.threads.erase(std::unique(cfg.threads.begin(), cfg.threads.end()), cfg.threads.end());
+
+        if (!compare.empty()) return compareResults(compare[0], compare[1], threshold) ? 2 : 0;
+
+        std::vector<ScaleRow> rows;
+        std::printf("%-9s %11s %7s %12s %12s %12s %14s %10s\n", "format", "levels", "threads",
+                    "p50 us", "p90 us", "p99 us", "throughput", "rss MB");
+        for (double n : cfg.levels) {
+            scaleLevels(cfg, static_cast<long long>(n), rows);
+            writeResults(cfg.out, rows);  // rewritten after every size, so a crash keeps what finished
+        }
+        std::printf("Wrote %zu rows to %s\n", rows.size(), cfg.out.c_str());
+    }
+    catch (const std::exception& e) {
+        std::cerr << "\n[ERROR] " << e.what() << "\n\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+// Byte order of the binary formats (OBR1 records, .obk snapshots, .obh history)
+
+// Converts between host and little-endian byte order; the same call works in both
+// directions. A no-op on little-endian hosts (x86, ARM), so files written on one
+// host are read unchanged on another.
+template <typename T>
+T littleEndian(T value) {
+    if constexpr (std::endian::native == std::endian::big) {
+        auto bytes = std::bit_cast<std::array<unsigned char, sizeof(T)>>(value);
+        std::reverse(bytes.begin(), bytes.end());
+        return std::bit_cast<T>(bytes);
+    } else {
+        return value;
+    }
+}
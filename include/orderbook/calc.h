@@ -0,0 +1,165 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <ranges>
+#include <cstdint>
+
+#include "orderbook/types.h"
+
+// Depth, VWAP and stats calculations on AoS books and SoA sides
+
+double calcDepth(const std::vector<Order>& orders, double minPrice, double maxPrice);
+
+template <Side S>
+[[noreturn]] void throwNotEnoughLiquidity(double targetQty) {
+    throw std::runtime_error(
+        std::string("Not enough liquidity to ") + SideTraits<S>::takerAction + " " +
+        std::to_string(targetQty) + " units."
+    );
+}
+
+// Size type of a range of {price, size} levels (double, or int64_t lots in fixed-point)
+template <typename Levels>
+using LevelSize = decltype(std::ranges::range_value_t<Levels>::size);
+
+template <typename Accum, typename Size>
+struct FillResult {
+    Accum notional;   // sum of filled * price, in the price type's accumulator
+    Size  remaining;  // quantity the levels could not fill
+};
+
+// Fills targetQty from the front of any best-first range of levels. All arithmetic
+// stays in the level's own types, so integer books never touch floating point.
+template <typename Levels>
+auto fillLevels(const Levels& levels, LevelSize<Levels> targetQty) {
+    using Level = std::ranges::range_value_t<Levels>;
+    using Price = decltype(Level::price);
+    using Size  = decltype(Level::size);
+    using Accum = typename PriceTraits<Price>::Accum;
+
+    FillResult<Accum, Size> fill{0, targetQty};
+    for (const auto& level : levels) {
+        if (fill.remaining <= 0) break;
+        Size filled     = std::min(fill.remaining, level.size);
+        fill.notional  += static_cast<Accum>(filled) * level.price;
+        fill.remaining -= filled;
+    }
+    return fill;
+}
+
+// Total size of side S priced inside [minPrice, maxPrice] on a best-first range of
+// {price, size} levels: one binary search to the near edge, then the contiguous run.
+// Sums in the level's size type, so fixed-point depth stays an exact integer.
+template <Side S, typename Levels, typename Price>
+LevelSize<Levels> calcDepthRun(const Levels& levels, Price minPrice, Price maxPrice) {
+    using Level = std::ranges::range_value_t<Levels>;
+    auto  better   = [](const Level& l, Price p) { return SideTraits<S>::better(l.price, p); };
+    Price nearEdge = SideTraits<S>::isBid ? maxPrice : minPrice;
+    Price farEdge  = SideTraits<S>::isBid ? minPrice : maxPrice;
+
+    LevelSize<Levels> total = 0;
+    for (auto it = std::lower_bound(levels.begin(), levels.end(), nearEdge, better);
+         it != levels.end() && !SideTraits<S>::better(farEdge, it->price); ++it)
+        total += it->size;
+    return total;
+}
+
+// VWAP of side S in price units of the level type. One instantiation per (side, level
+// type), so both sides compile to the same tight loop.
+template <Side S, typename Levels>
+double calcVWAP(const Levels& levels, LevelSize<Levels> targetQty) {
+    using Price = decltype(std::ranges::range_value_t<Levels>::price);
+    auto fill = fillLevels(levels, targetQty);
+    if (fill.remaining > 0) throwNotEnoughLiquidity<S>(static_cast<double>(targetQty));
+    return PriceTraits<Price>::toDouble(fill.notional) / static_cast<double>(targetQty);
+}
+
+// Walk asks from cheapest to most expensive, accumulate volume-weighted cost
+double calcVWAPBuy(const std::vector<Order>& asks, double targetQty);
+
+// Walk bids from most expensive to cheapest, accumulate volume-weighted revenue
+double calcVWAPSell(const std::vector<Order>& bids, double targetQty);
+
+// Refills `side` in place, reusing its capacity
+void assignBookSide(const std::vector<Order>& orders, BookSide& side);
+
+BookSide toBookSide(const std::vector<Order>& orders);
+
+SoABook toSoA(const Orderbook& book);
+
+void toSoA(const Orderbook& book, SoABook& out);
+
+double calcDepth(const BookSide& side, double minPrice, double maxPrice);
+
+// O(log n) depth for a sorted side: levels inside [minPrice, maxPrice] form one contiguous
+// run, found with two binary searches, and its volume is a difference of prefix sums.
+template <Side S>
+double calcDepthIndexed(const BookSide& side, double minPrice, double maxPrice) {
+    auto better = [](double a, double b) { return SideTraits<S>::better(a, b); };
+    // In best-first order the run starts at the first price not better than the window
+    // edge nearest the touch and ends at the first price worse than the far edge
+    double nearEdge = SideTraits<S>::isBid ? maxPrice : minPrice;
+    double farEdge  = SideTraits<S>::isBid ? minPrice : maxPrice;
+
+    auto begin = side.prices.begin(), end = side.prices.end();
+    auto first = std::lower_bound(begin, end, nearEdge, better);
+    auto last  = std::upper_bound(begin, end, farEdge,  better);
+    if (first >= last) return 0.0;
+    return side.cumSize[last - begin] - side.cumSize[first - begin];
+}
+
+struct DepthPoint {
+    double depthPct;
+    double bidDepth;
+    double askDepth;
+};
+
+// Liquidity curve: depth within ±pct of mid for every requested percentage
+std::vector<DepthPoint> calcDepthCurve(const SoABook& book, const std::vector<double>& depthPcts);
+
+// Fills from the best level outward and returns the notional; `remaining` is what
+// could not be filled. Both sides are stored best-first, so one walk serves buy and sell.
+double fillNotional(const BookSide& side, double targetQty, double& remaining);
+
+// SoA walk: same semantics as calcVWAP, but through the dispatched SIMD fill kernel
+template <Side S>
+double calcVWAP(const BookSide& side, double targetQty) {
+    double remaining = 0.0;
+    double notional  = fillNotional(side, targetQty, remaining);
+    if (remaining > 0.0) throwNotEnoughLiquidity<S>(targetQty);
+    return notional / targetQty;
+}
+
+double calcVWAPBuy (const BookSide& asks, double targetQty);
+
+double calcVWAPSell(const BookSide& bids, double targetQty);
+
+// VWAP for every target in `sortedQtys` (ascending) with one best-first walk: the level
+// cursor only moves forward, and each answer is prefix notional plus a partial level.
+// Targets the side cannot fill get NaN instead of an exception.
+std::vector<double> calcVWAPBatch(const BookSide& side, const std::vector<double>& sortedQtys);
+
+struct ImpactPoint {
+    double qty;
+    double vwapBuy;          // NaN when asks cannot fill qty
+    double vwapSell;         // NaN when bids cannot fill qty
+    double buySlippagePct;   // (vwapBuy - mid) / mid, in percent
+    double sellSlippagePct;  // (mid - vwapSell) / mid, in percent
+};
+
+// Market-impact curve: buy and sell VWAP plus slippage vs mid for every target size
+std::vector<ImpactPoint> calcImpactCurve(const SoABook& book, const std::vector<double>& sortedQtys);
+
+// Best prices, spread and window depth; the fields every stats variant shares
+void calcTopOfBook(const SoABook& book, double depthPct, Stats& s);
+
+Stats calcStats(const SoABook& book, double depthPct, double targetQty);
+
+// Like calcStats, but a side too thin for targetQty yields a NaN VWAP instead of throwing
+Stats calcStatsNoThrow(const SoABook& book, double depthPct, double targetQty);
+
+// AoS entry point kept for callers holding an Orderbook
+Stats calcStats(const Orderbook& book, double depthPct, double targetQty);
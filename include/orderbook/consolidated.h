@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "orderbook/incremental.h"
+#include "orderbook/types.h"
+
+// Cross-venue consolidated book
+
+// One level of the consolidated book, tagged with the venue it came from
+struct VenueLevel {
+    double   price;
+    double   size;
+    uint32_t venue;
+};
+
+struct ConsolidatedStats {
+    double   bestBid;
+    uint32_t bestBidVenue;
+    double   bestAsk;
+    uint32_t bestAskVenue;
+    double   midPrice;
+    double   spread;      // bestAsk - bestBid; negative when venues cross each other
+    double   spreadPct;
+    double   arbQty;      // size buyable on one venue below another venue's bid
+    double   arbProfit;   // notional gained by buying and selling all of arbQty
+    double   vwapBuy;     // consolidated, NaN when all venues together cannot fill
+    double   vwapSell;
+};
+
+// N venue books merged into one book per side, keeping every venue's level
+// separately (equal prices are ordered by venue id). The initial build is a k-way
+// merge of the already sorted venue sides; afterwards a venue update is one binary
+// search and insert/erase in the merged side, and replacing one venue's whole
+// snapshot is a single linear merge, so the other venues are never re-merged. Like
+// IncrementalBook, sides are stored worst-first so updates near the touch only shift
+// the few levels behind them.
+class ConsolidatedBook {
+public:
+    // Registers a venue and returns its id (ids are dense, starting at 0)
+    uint32_t addVenue(std::string name);
+
+    // Rebuilds both sides from every venue's sorted book with one k-way merge;
+    // books[i] belongs to venue i
+    void build(std::span<const Orderbook> books);
+
+    // Replaces one venue's levels with a new sorted snapshot
+    void replaceVenue(uint32_t venue, const Orderbook& book);
+
+    // Applies one L2 delta from `venue` (size 0 removes its level at that price)
+    void apply(uint32_t venue, const LevelUpdate& update);
+
+    // Best-first views of the merged sides
+    auto bids() const { return std::views::reverse(bids_); }
+    auto asks() const { return std::views::reverse(asks_); }
+
+    size_t             venueCount()          const { return names_.size(); }
+    const std::string& venueName(uint32_t v) const { return names_[v]; }
+
+    ConsolidatedStats stats(double targetQty) const;
+
+    // Per-venue share of filling targetQty on one side (asks = buying); `perVenue` is
+    // resized to venueCount(). Returns the quantity left unfilled.
+    double fillByVenue(Side side, double targetQty, std::vector<double>& perVenue) const;
+
+private:
+    std::vector<std::string> names_;
+    std::vector<VenueLevel>  bids_;  // worst-first: ascending price, best bid at back()
+    std::vector<VenueLevel>  asks_;  // worst-first: descending price, best ask at back()
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "orderbook/types.h"
+
+// Execution-cost queries over the cumulative (quantity, notional) curve of a side
+
+// BookSide's prefix arrays are that curve, sampled at level boundaries: cumSize[k]
+// and cumNotional[k] are the totals of the best k levels, and between boundaries it
+// is linear with slope prices[k]. Built once per snapshot by toSoA, every query below
+// is one binary search plus a partial level: O(log n), no allocation.
+
+struct CostPoint {
+    double qty;       // quantity executed
+    double notional;  // cost of buying it, or proceeds of selling it
+    double vwap;      // notional / qty; NaN when qty is 0
+    bool   complete;  // false when the side ran out before the request was met
+};
+
+// Buying qty walks asks, selling walks bids; with an unfillable qty the result covers
+// the whole side and complete is false
+CostPoint costForQty(const BookSide& side, double qty);
+
+// Largest quantity whose VWAP stays within `bps` basis points of refPrice, worse
+// direction only (above it for asks, below for bids). A side's running VWAP only ever
+// gets worse, so full levels are found by binary search and the last, partial level
+// solves (N + x*p) / (Q + x) = limit for x.
+template <Side S>
+double maxQtyWithin(const BookSide& side, double refPrice, double bps) {
+    double limit = SideTraits<S>::isBid ? refPrice * (1.0 - bps / 1e4) : refPrice * (1.0 + bps / 1e4);
+    // withinLimit(k): the best k levels, taken whole, average no worse than limit
+    auto withinLimit = [&](size_t k) {
+        return SideTraits<S>::isBid ? side.cumNotional[k] >= limit * side.cumSize[k]
+                                    : side.cumNotional[k] <= limit * side.cumSize[k];
+    };
+
+    size_t lo = 0, hi = side.size();  // withinLimit(lo) holds; find the last k that does
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo + 1) / 2;
+        if (withinLimit(mid)) lo = mid;
+        else                  hi = mid - 1;
+    }
+    if (lo == side.size()) return side.cumSize[lo];
+
+    double price = side.prices[lo];
+    if (price == limit) return side.cumSize[lo + 1];
+    double partial = (limit * side.cumSize[lo] - side.cumNotional[lo]) / (price - limit);
+    return side.cumSize[lo] + std::clamp(partial, 0.0, side.sizes[lo]);
+}
+
+// Quantity and cost of taking every level priced better than `price`, so the touch
+// moves to `price` or beyond: asks below it when buying, bids above it when selling.
+// complete is false when the whole side is better than `price`.
+template <Side S>
+CostPoint costToReach(const BookSide& side, double price) {
+    auto better = [](double a, double b) { return SideTraits<S>::better(a, b); };
+    size_t k = std::lower_bound(side.prices.begin(), side.prices.end(), price, better) - side.prices.begin();
+    double qty = side.cumSize[k];
+    double notional = side.cumNotional[k];
+    return {qty, notional, qty > 0.0 ? notional / qty : std::numeric_limits<double>::quiet_NaN(),
+            k < side.size()};
+}
+
+// Most a buy and a sell can take while staying within each bps limit of the mid
+struct SlippagePoint {
+    double bps;
+    double buyQty;
+    double buyVWAP;
+    double sellQty;
+    double sellVWAP;
+};
+
+std::vector<SlippagePoint> calcSlippageCapacity(const SoABook& book, const std::vector<double>& bpsLimits);
+
+// Cost of pushing the touch to each target: prices above the best ask are reached by
+// buying, prices below the best bid by selling, anything inside the spread costs nothing
+struct PriceMovePoint {
+    double    price;
+    Side      side;  // the side consumed (ASK = buying)
+    CostPoint cost;
+};
+
+std::vector<PriceMovePoint> calcPriceMoves(const SoABook& book, const std::vector<double>& prices);
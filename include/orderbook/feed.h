@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#include "orderbook/incremental.h"
+#include "orderbook/types.h"
+
+// Live feed ingestion: network thread -> SPSC ring -> book thread -> seqlock -> readers
+
+constexpr size_t CACHE_LINE = 64;
+
+// Bounded single-producer / single-consumer queue. Head and tail live on separate
+// cache lines, and each side caches the other's index so the common case touches
+// only its own line. Capacity must be a power of two. The slots are allocated once,
+// on the heap, so a ring of any size can live in a stack object; no operation allocates.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "Ring elements are copied by value");
+
+public:
+    // Producer only; false when the ring is full
+    bool tryPush(const T& item) noexcept {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - headCache_ == Capacity) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (tail - headCache_ == Capacity) return false;
+        }
+        slots_[tail & (Capacity - 1)] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only; false when the ring is empty
+    bool tryPop(T& item) noexcept {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head == tailCache_) return false;
+        }
+        item = slots_[head & (Capacity - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+    size_t                                  tailCache_ = 0;  // consumer's view of tail_
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+    size_t                                  headCache_ = 0;  // producer's view of head_
+    std::unique_ptr<T[]>                    slots_ = std::make_unique<T[]>(Capacity);
+};
+
+// Single-writer seqlock. The writer never waits; readers retry while a write is in
+// flight. The payload is kept as relaxed atomic words, so a torn read is a detected
+// retry rather than a data race.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock payload is copied bytewise");
+    static constexpr size_t WORDS = (sizeof(T) + 7) / 8;
+
+public:
+    void store(const T& value) noexcept {
+        uint64_t words[WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);  // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) data_[i].store(words[i], std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    T load() const noexcept {
+        uint64_t words[WORDS];
+        uint64_t before, after;
+        do {
+            before = seq_.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; i++) words[i] = data_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq_.load(std::memory_order_relaxed);
+        } while (before != after || (before & 1));
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+private:
+    alignas(CACHE_LINE) std::atomic<uint64_t> seq_{0};
+    std::array<std::atomic<uint64_t>, WORDS>  data_{};
+};
+
+// One parsed level update, stamped when its datagram arrived
+struct FeedMessage {
+    LevelUpdate update;
+    int64_t     recvNanos;  // steady_clock
+};
+
+// What readers see: the latest stats plus pipeline counters
+struct FeedSnapshot {
+    Stats    stats;
+    uint64_t valid;           // 0 while the book is empty or crossed
+    uint64_t updates;         // level updates applied so far
+    uint64_t parseErrors;     // malformed rows skipped by the network thread
+    int64_t  latencyNanos;    // receive -> published, for the last update in the batch
+};
+
+struct FeedConfig {
+    uint16_t port          = 0;
+    double   depthPct      = 0.5;
+    double   targetQty     = 40.0;
+    size_t   reserveLevels = 1 << 16;  // per side, so steady-state inserts never allocate
+};
+
+// The three-stage pipeline. Datagrams carry one or more `side,price,size` rows
+// (size 0 removes the level, as in --deltas files). The network thread parses them
+// in place and pushes FeedMessages; the book thread applies each batch to an
+// IncrementalBook and publishes a FeedSnapshot. Nothing on that path locks or
+// allocates: the ring is fixed-size, the book is pre-reserved, and rows are
+// string_views into one receive buffer. Malformed rows are counted, not thrown.
+class FeedPipeline {
+public:
+    static constexpr size_t RING_CAPACITY = 1 << 16;
+
+    // `snapshot` seeds the book (may be empty); binds the UDP port immediately
+    FeedPipeline(const FeedConfig& config, const Orderbook& snapshot);
+    ~FeedPipeline();
+
+    FeedPipeline(const FeedPipeline&)            = delete;
+    FeedPipeline& operator=(const FeedPipeline&) = delete;
+
+    void start();
+    void stop();
+
+    // Wait-free for the writer, lock-free for the caller; callable from any thread
+    FeedSnapshot latest() const noexcept { return published_.load(); }
+
+    uint16_t port() const noexcept { return boundPort_; }
+
+private:
+    void receiveLoop();
+    void bookLoop();
+    void publish(int64_t recvNanos);
+
+    FeedConfig      config_;
+    IncrementalBook book_;
+    int             socket_    = -1;
+    uint16_t        boundPort_ = 0;
+
+    SpscRing<FeedMessage, RING_CAPACITY> ring_;
+    SeqLock<FeedSnapshot>                published_;
+
+    std::atomic<bool>     running_{false};
+    std::atomic<uint64_t> parseErrors_{0};
+    uint64_t              updates_ = 0;  // book thread only
+
+    std::thread network_;
+    std::thread bookThread_;
+};
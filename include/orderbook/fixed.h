@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "orderbook/types.h"
+
+// Fixed-point (integer tick / lot) book and exact stats
+
+// Price in integer ticks, size in integer lots
+struct FixedOrder {
+    int64_t price;
+    int64_t size;
+};
+
+// Same best-first invariant as Orderbook, in exact integer units
+struct FixedBook {
+    double tickSize;
+    double lotSize;
+    std::vector<FixedOrder> bids;
+    std::vector<FixedOrder> asks;
+};
+
+// Converts a loaded (sorted, validated) book to ticks and lots; 0 infers the increment
+FixedBook toFixed(const Orderbook& book, double tickSize, double lotSize);
+
+// calcStats on integer ticks and lots. The window edges are rounded inward to whole
+// ticks once, so membership is exact and identical on every run; results are
+// converted back to price units only at the end.
+Stats calcStatsFixed(const FixedBook& book, double depthPct, double targetQty);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// Synthetic order books: one snapshot, timestamped snapshot streams, L2 deltas
+
+enum class SizeModel { UNIFORM, LOGNORMAL, PARETO };
+enum class RngKind   { MT19937, XOSHIRO };
+
+struct GeneratorConfig {
+    std::string filename   = "orderbook.csv";
+    int         levels     = 10;      // number of price levels per side
+    double      midPrice   = 100.0;   // starting mid price
+    double      tickSize   = 0.10;    // price step between levels
+    double      maxSize    = 50.0;    // max order size
+    double      minSize    = 1.0;     // min order size
+    unsigned    threads    = 0;       // formatting threads, 0 = all cores
+    int         snapshots  = 1;       // > 1 writes a timestamped multi-snapshot stream
+    long long   deltas     = 0;       // L2 updates written to deltasFile after the snapshot
+    std::string deltasFile;
+
+    std::optional<uint64_t> seed;              // unset = hardware entropy
+    RngKind     rng         = RngKind::MT19937;
+    SizeModel   sizeModel   = SizeModel::UNIFORM;
+    double      sizeSigma   = 1.0;     // lognormal: sigma of log(size)
+    double      paretoAlpha = 1.5;     // pareto: tail index, smaller = heavier tail
+    double      gapProb     = 0.0;     // chance that a price level is left empty
+    int         roundEvery  = 0;       // every Nth tick is a round price with extra size, 0 = off
+    double      roundBoost  = 5.0;     // size multiplier at round prices
+};
+
+// One book, or cfg.snapshots timestamped ones, as CSV in cfg.filename; the output
+// depends on the seed only, never on cfg.threads
+void generateCSV(const GeneratorConfig& cfg);
+
+// The same book as a binary snapshot (see snapshot_format.h)
+void generateBinary(const GeneratorConfig& cfg);
+
+// cfg.deltas L2 updates against the generated snapshot, written to cfg.deltasFile
+void generateDeltas(const GeneratorConfig& cfg);
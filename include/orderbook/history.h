@@ -0,0 +1,182 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "orderbook/byte_order.h"
+#include "orderbook/load.h"
+#include "orderbook/types.h"
+
+struct FixedBook;
+
+// Columnar on-disk history of snapshots and their Stats
+
+// File layout (little-endian, see littleEndian):
+//   HistoryHeader
+//   chunk*            — HistoryChunkHeader, then its columns back to back
+//   HistoryChunkIndex index[chunkCount]
+//   HistoryTail
+// A chunk holds up to `chunkSnapshots` consecutive snapshots as HISTORY_COLUMNS
+// independent byte columns, so a reader touches only the columns it asks for:
+//   TIME        zigzag varint delta from the previous timestamp (the first is absolute)
+//   COUNTS      varint bid count, varint ask count, per snapshot
+//   BID_PRICES  per snapshot: zigzag delta of the best price vs the previous snapshot's
+//               best, then varint tick gaps between consecutive levels
+//   BID_SIZES   varint lots
+//   ASK_PRICES, ASK_SIZES  the same for asks
+//   STATS       the 9 statsValues() doubles, raw little-endian
+// Prices and sizes are stored as integer ticks and lots (see toFixed) on the grid
+// recorded in the chunk's index entry. Deltas restart at every chunk, so any chunk
+// decodes on its own; the index maps each chunk to its time range for binary search.
+
+constexpr char     HISTORY_MAGIC[4] = {'O', 'B', 'H', '1'};
+constexpr char     HISTORY_TAIL[4]  = {'O', 'B', 'H', 'I'};
+constexpr uint32_t HISTORY_VERSION  = 2;
+constexpr size_t   HISTORY_COLUMNS  = 7;
+
+enum HistoryColumnId : size_t { TIME, COUNTS, BID_PRICES, BID_SIZES, ASK_PRICES, ASK_SIZES, STATS };
+
+struct HistoryHeader {
+    char     magic[4];
+    uint32_t version;
+};
+
+struct HistoryChunkHeader {
+    uint64_t snapshots;
+    uint64_t columnBytes[HISTORY_COLUMNS];
+};
+
+struct HistoryChunkIndex {
+    int64_t  firstTime;
+    int64_t  lastTime;
+    uint64_t offset;     // of the HistoryChunkHeader
+    uint64_t snapshots;
+    double   tickSize;   // the grid this chunk's prices and sizes are stored on
+    double   lotSize;
+};
+
+struct HistoryTail {
+    uint64_t indexOffset;
+    uint64_t chunkCount;
+    double   tickSize;   // finest tick / lot of any chunk
+    double   lotSize;
+    char     magic[4];
+    uint32_t version;
+};
+
+static_assert(sizeof(HistoryHeader)      == 8,  "HistoryHeader must stay packed");
+static_assert(sizeof(HistoryChunkHeader) == 64, "HistoryChunkHeader must stay packed");
+static_assert(sizeof(HistoryChunkIndex)  == 48, "HistoryChunkIndex must stay packed");
+static_assert(sizeof(HistoryTail)        == 40, "HistoryTail must stay packed");
+
+// Swaps every numeric field between host and file byte order (see littleEndian)
+inline HistoryChunkHeader littleEndian(HistoryChunkHeader header) {
+    header.snapshots = littleEndian(header.snapshots);
+    for (auto& bytes : header.columnBytes) bytes = littleEndian(bytes);
+    return header;
+}
+
+inline HistoryChunkIndex littleEndian(HistoryChunkIndex chunk) {
+    return {littleEndian(chunk.firstTime), littleEndian(chunk.lastTime), littleEndian(chunk.offset),
+            littleEndian(chunk.snapshots), littleEndian(chunk.tickSize), littleEndian(chunk.lotSize)};
+}
+
+inline HistoryTail littleEndian(HistoryTail tail) {
+    tail.indexOffset = littleEndian(tail.indexOffset);
+    tail.chunkCount  = littleEndian(tail.chunkCount);
+    tail.tickSize    = littleEndian(tail.tickSize);
+    tail.lotSize     = littleEndian(tail.lotSize);
+    tail.version     = littleEndian(tail.version);
+    return tail;
+}
+
+// Appends snapshots chunk by chunk; only the current chunk is held in memory
+class HistoryWriter {
+public:
+    // tickSize / lotSize of 0 are inferred: from the first snapshot, then refined
+    // whenever a snapshot needs a finer grid, which closes the current chunk so each
+    // chunk keeps its own grid. An explicit size that a snapshot does not fit throws
+    // before anything of that snapshot is written.
+    explicit HistoryWriter(const std::string& filename, double tickSize = 0.0, double lotSize = 0.0,
+                           size_t chunkSnapshots = 1024);
+    ~HistoryWriter();
+
+    HistoryWriter(const HistoryWriter&)            = delete;
+    HistoryWriter& operator=(const HistoryWriter&) = delete;
+
+    // `book` must be finalized (sorted best-first); timestamps must not decrease
+    void append(int64_t timestamp, const Orderbook& book, const Stats& stats);
+
+    // Writes the last chunk, the index and the tail; called by the destructor if needed
+    void finish();
+
+    uint64_t snapshots() const { return total_; }
+
+private:
+    FixedBook toChunkGrid(const Orderbook& book);
+    void      flushChunk();
+
+    std::string   filename_;
+    std::ofstream file_;
+    double        tickSize_;       // as given; 0 = inferred
+    double        lotSize_;
+    double        chunkTick_ = 0.0;  // grid of the chunk being filled, 0 before the first snapshot
+    double        chunkLot_  = 0.0;
+    double        finestTick_ = 0.0;
+    double        finestLot_  = 0.0;
+    size_t        chunkSnapshots_;
+    bool          finished_ = false;
+
+    std::array<std::vector<uint8_t>, HISTORY_COLUMNS> columns_;
+    std::vector<HistoryChunkIndex>                    index_;
+    HistoryChunkIndex chunk_{};        // the chunk being filled
+    uint64_t          offset_  = 0;    // bytes written so far
+    uint64_t          total_   = 0;
+    int64_t           prevTime_ = 0;
+    int64_t           prevBid_  = 0;   // previous snapshot's best bid tick, this chunk
+    int64_t           prevAsk_  = 0;
+};
+
+// Which columns a replay decodes, and over which time range (inclusive)
+enum HistoryColumns : unsigned { HISTORY_STATS = 1, HISTORY_BIDS = 2, HISTORY_ASKS = 4 };
+
+struct HistoryQuery {
+    int64_t  from      = std::numeric_limits<int64_t>::min();
+    int64_t  to        = std::numeric_limits<int64_t>::max();
+    unsigned columns   = HISTORY_STATS;
+    size_t   maxLevels = 0;  // levels decoded per side, 0 = all; the rest are skipped
+};
+
+// One replayed snapshot; only the requested parts are filled. The book's buffers
+// are reused from record to record.
+struct HistoryRecord {
+    int64_t   timestamp;
+    Stats     stats;
+    Orderbook book;
+};
+
+// Memory-maps a history file and replays any time range of it
+class HistoryReader {
+public:
+    explicit HistoryReader(const std::string& filename);
+
+    uint64_t snapshots()  const;
+    size_t   chunkCount() const { return index_.size(); }
+    double   tickSize()   const { return tail_.tickSize; }
+    double   lotSize()    const { return tail_.lotSize; }
+
+    // Calls `visit` for every snapshot in [query.from, query.to], in time order.
+    // Only chunks overlapping the range are touched. Returns the number visited.
+    size_t replay(const HistoryQuery& query, const std::function<void(const HistoryRecord&)>& visit) const;
+
+private:
+    std::string                    filename_;
+    MappedFile                     file_;
+    HistoryTail                    tail_{};
+    std::vector<HistoryChunkIndex> index_;
+};
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <string_view>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <ranges>
+
+#include "orderbook/types.h"
+#include "orderbook/calc.h"
+
+// Order book maintained in place from L2 level updates
+
+// L2 delta: set the size of a price level, or remove it when size == 0
+struct LevelUpdate {
+    Side   side;
+    double price;
+    double size;
+};
+
+LevelUpdate parseUpdateRow(std::string_view line, int lineNumber);
+
+// parseUpdateRow without exceptions, for the feed's network thread: false on a row it
+// would reject, and `update` is then unspecified
+bool tryParseUpdateRow(std::string_view line, LevelUpdate& update) noexcept;
+
+// Order book maintained in place from L2 deltas. Each side is a flat sorted vector
+// stored worst-first, so the best level is back(): updates cluster near the touch and
+// shift only a few elements. Best bid/ask are O(1); depth inside the ±depthPct window
+// is kept as a running total and adjusted per delta, and when the mid moves only the
+// levels that enter or leave the window are visited. Every DEPTH_RESYNC adjustments the
+// totals are re-summed from the window's levels, so rounding in the += / -= chain
+// cannot accumulate over a long feed.
+class IncrementalBook {
+public:
+    explicit IncrementalBook(double depthPct) : depthPct_(depthPct) {}
+
+    // Replaces the whole book with a loaded (sorted, validated) snapshot
+    void reset(const Orderbook& snapshot) {
+        bids_.assign(snapshot.bids.size(), {});
+        asks_.assign(snapshot.asks.size(), {});
+        std::transform(snapshot.bids.rbegin(), snapshot.bids.rend(), bids_.begin(),
+                       [](const Order& o) { return Level{o.price, o.size}; });
+        std::transform(snapshot.asks.rbegin(), snapshot.asks.rend(), asks_.begin(),
+                       [](const Order& o) { return Level{o.price, o.size}; });
+        resyncWindow();
+    }
+
+    void apply(const LevelUpdate& update) {
+        bool   isBid  = update.side == Side::BID;
+        auto&  levels = isBid ? bids_ : asks_;
+        double delta  = setLevel(levels, isBid, update.price, update.size);
+
+        if (update.price >= windowLow_ && update.price <= windowHigh_) {
+            (isBid ? bidDepth_ : askDepth_) += delta;
+            adjustments_++;
+        }
+
+        if (midPrice() != windowMid_) moveWindow();
+        if (adjustments_ >= DEPTH_RESYNC) resyncDepth();
+    }
+
+    bool   empty()    const { return bids_.empty() || asks_.empty(); }
+    double bestBid()  const { return bids_.back().price; }
+    double bestAsk()  const { return asks_.back().price; }
+    double midPrice() const { return empty() ? 0.0 : (bestBid() + bestAsk()) / 2.0; }
+    double bidDepth() const { return bidDepth_; }
+    double askDepth() const { return askDepth_; }
+    size_t bidLevels() const { return bids_.size(); }
+    size_t askLevels() const { return asks_.size(); }
+
+    // Same fields and errors as calcStats; only the VWAPs walk levels (from the touch)
+    Stats stats(double targetQty) const {
+        if (bids_.empty()) throw std::runtime_error("No bids in book.");
+        if (asks_.empty()) throw std::runtime_error("No asks in book.");
+        if (bestBid() >= bestAsk())
+            throw std::runtime_error(
+                "Crossed book: best bid (" + std::to_string(bestBid()) +
+                ") >= best ask ("          + std::to_string(bestAsk()) + ")."
+            );
+
+        Stats s;
+        s.bestBid   = bestBid();
+        s.bestAsk   = bestAsk();
+        s.midPrice  = midPrice();
+        s.spread    = s.bestAsk - s.bestBid;
+        s.spreadPct = (s.spread / s.midPrice) * 100.0;
+        s.bidDepth  = bidDepth_;
+        s.askDepth  = askDepth_;
+        s.vwapBuy   = calcVWAP<Side::ASK>(std::views::reverse(asks_), targetQty);
+        s.vwapSell  = calcVWAP<Side::BID>(std::views::reverse(bids_), targetQty);
+        return s;
+    }
+
+    // Feed hot-path variant of stats(): never throws or allocates. Returns false for an
+    // empty or crossed book; a side too thin for targetQty gets a NaN VWAP.
+    bool tryStats(double targetQty, Stats& s) const noexcept {
+        if (empty() || bestBid() >= bestAsk()) return false;
+
+        const double NaN = std::numeric_limits<double>::quiet_NaN();
+        auto buy  = fillLevels(std::views::reverse(asks_), targetQty);
+        auto sell = fillLevels(std::views::reverse(bids_), targetQty);
+        s.bestBid   = bestBid();
+        s.bestAsk   = bestAsk();
+        s.midPrice  = midPrice();
+        s.spread    = s.bestAsk - s.bestBid;
+        s.spreadPct = (s.spread / s.midPrice) * 100.0;
+        s.bidDepth  = bidDepth_;
+        s.askDepth  = askDepth_;
+        s.vwapBuy   = buy.remaining  > 0.0 ? NaN : buy.notional  / targetQty;
+        s.vwapSell  = sell.remaining > 0.0 ? NaN : sell.notional / targetQty;
+        return true;
+    }
+
+    // Pre-sizes both sides so inserts up to this many levels never reallocate
+    void reserve(size_t levelsPerSide) {
+        bids_.reserve(levelsPerSide);
+        asks_.reserve(levelsPerSide);
+    }
+
+private:
+    // Strict "a is worse than b" for a worst-first side
+    static bool worse(bool isBid, double a, double b) { return isBid ? a < b : a > b; }
+
+    // Sets (or removes, for size 0) one level and returns the size change
+    static double setLevel(std::vector<Level>& levels, bool isBid, double price, double size) {
+        auto it = std::lower_bound(levels.begin(), levels.end(), price,
+            [isBid](const Level& l, double p) { return worse(isBid, l.price, p); });
+        bool exists = it != levels.end() && it->price == price;
+
+        double old = exists ? it->size : 0.0;
+        if (size == 0.0) {
+            if (exists) levels.erase(it);
+        } else if (exists) {
+            it->size = size;
+        } else {
+            levels.insert(it, Level{price, size});
+        }
+        return size - old;
+    }
+
+    // Index range [first, last) of levels priced inside [low, high]
+    static std::pair<size_t, size_t> windowRange(const std::vector<Level>& levels, bool isBid,
+                                                 double low, double high) {
+        auto byPrice = [isBid](const Level& l, double p) { return worse(isBid, l.price, p); };
+        auto lo = std::lower_bound(levels.begin(), levels.end(), isBid ? low  : high, byPrice);
+        auto hi = std::upper_bound(levels.begin(), levels.end(), isBid ? high : low,
+            [isBid](double p, const Level& l) { return worse(isBid, p, l.price); });
+        if (hi < lo) hi = lo;
+        return {size_t(lo - levels.begin()), size_t(hi - levels.begin())};
+    }
+
+    static double sumSizes(const std::vector<Level>& levels, size_t first, size_t last) {
+        double total = 0.0;
+        for (size_t i = first; i < last; i++) total += levels[i].size;
+        return total;
+    }
+
+    // Moves one side's depth from the old window range to the new one by visiting
+    // only the symmetric difference of the two index ranges
+    static double shiftDepth(const std::vector<Level>& levels, double depth,
+                             std::pair<size_t, size_t> from, std::pair<size_t, size_t> to) {
+        if (to.first >= to.second) return 0.0;
+        if (from.first >= from.second || from.second <= to.first || to.second <= from.first)
+            return sumSizes(levels, to.first, to.second);
+
+        if (to.first < from.first)   depth += sumSizes(levels, to.first, from.first);
+        else                         depth -= sumSizes(levels, from.first, to.first);
+        if (to.second > from.second) depth += sumSizes(levels, from.second, to.second);
+        else                         depth -= sumSizes(levels, to.second, from.second);
+        return depth;
+    }
+
+    void moveWindow() {
+        double low = windowLow_, high = windowHigh_;
+        auto oldBids = windowRange(bids_, true,  low, high);
+        auto oldAsks = windowRange(asks_, false, low, high);
+        setWindowBounds();
+        bidDepth_ = shiftDepth(bids_, bidDepth_, oldBids, windowRange(bids_, true,  windowLow_, windowHigh_));
+        askDepth_ = shiftDepth(asks_, askDepth_, oldAsks, windowRange(asks_, false, windowLow_, windowHigh_));
+        adjustments_++;
+    }
+
+    void resyncWindow() {
+        setWindowBounds();
+        resyncDepth();
+    }
+
+    // Exact totals of the current window, discarding any accumulated rounding
+    void resyncDepth() {
+        auto bids = windowRange(bids_, true,  windowLow_, windowHigh_);
+        auto asks = windowRange(asks_, false, windowLow_, windowHigh_);
+        bidDepth_    = sumSizes(bids_, bids.first, bids.second);
+        askDepth_    = sumSizes(asks_, asks.first, asks.second);
+        adjustments_ = 0;
+    }
+
+    // An empty side leaves no mid, so the window collapses to nothing
+    void setWindowBounds() {
+        windowMid_ = midPrice();
+        if (empty()) {
+            windowLow_  = std::numeric_limits<double>::infinity();
+            windowHigh_ = -windowLow_;
+            return;
+        }
+        windowLow_  = windowMid_ * (1.0 - depthPct_ / 100.0);
+        windowHigh_ = windowMid_ * (1.0 + depthPct_ / 100.0);
+    }
+
+    // Running-total adjustments between exact re-sums; one re-sum costs about as much as
+    // one window shift, so this keeps the amortized cost per update unchanged
+    static constexpr unsigned DEPTH_RESYNC = 1024;
+
+    std::vector<Level> bids_;  // ascending price, best at back()
+    std::vector<Level> asks_;  // descending price, best at back()
+    double depthPct_;
+    double windowMid_  = 0.0;
+    double windowLow_  = 0.0;
+    double windowHigh_ = 0.0;
+    double bidDepth_   = 0.0;
+    double askDepth_   = 0.0;
+    unsigned adjustments_ = 0;  // since the last resyncDepth()
+};
+
+// Applies every row of an update file (same CSV layout, size 0 removes a level)
+size_t applyUpdatesCSV(IncrementalBook& book, const std::string& filename);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <optional>
+
+#include "orderbook/types.h"
+#include "orderbook/calc.h"
+
+// Stats view that computes and memoizes each metric on first access
+
+// Stats view over a loaded Orderbook where each metric is computed on first access
+// and memoized. Prices and spread are O(1) reads of the touch; depth and VWAP walk
+// the AoS sides only when asked for, with no SoA copy. A VWAP the book cannot fill
+// is an empty optional for that metric alone instead of an exception.
+class LazyStats {
+public:
+    // `book` must outlive the view and stay unchanged while it is in use
+    LazyStats(const Orderbook& book, double depthPct, double targetQty)
+        : book_(book), depthPct_(depthPct), targetQty_(targetQty) {}
+
+    double bestBid()   const { return book_.bids[0].price; }
+    double bestAsk()   const { return book_.asks[0].price; }
+    double midPrice()  const { return (bestBid() + bestAsk()) / 2.0; }
+    double spread()    const { return bestAsk() - bestBid(); }
+    double spreadPct() const { return spread() / midPrice() * 100.0; }
+
+    double bidDepth() const {
+        if (!bidDepth_) bidDepth_ = calcDepthRun<Side::BID>(book_.bids, lowerBound(), upperBound());
+        return *bidDepth_;
+    }
+    double askDepth() const {
+        if (!askDepth_) askDepth_ = calcDepthRun<Side::ASK>(book_.asks, lowerBound(), upperBound());
+        return *askDepth_;
+    }
+
+    std::optional<double> vwapBuy() const {
+        if (!vwapBuy_) vwapBuy_ = vwap(book_.asks);
+        return *vwapBuy_;
+    }
+    std::optional<double> vwapSell() const {
+        if (!vwapSell_) vwapSell_ = vwap(book_.bids);
+        return *vwapSell_;
+    }
+
+    // Every metric at once; unfillable VWAPs are NaN, as in calcStatsNoThrow
+    Stats all() const {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        Stats s;
+        s.bestBid   = bestBid();
+        s.bestAsk   = bestAsk();
+        s.midPrice  = midPrice();
+        s.spread    = spread();
+        s.spreadPct = spreadPct();
+        s.bidDepth  = bidDepth();
+        s.askDepth  = askDepth();
+        s.vwapBuy   = vwapBuy().value_or(nan);
+        s.vwapSell  = vwapSell().value_or(nan);
+        return s;
+    }
+
+private:
+    double lowerBound() const { return midPrice() * (1.0 - depthPct_ / 100.0); }
+    double upperBound() const { return midPrice() * (1.0 + depthPct_ / 100.0); }
+
+    std::optional<double> vwap(const std::vector<Order>& levels) const {
+        auto fill = fillLevels(levels, targetQty_);
+        if (fill.remaining > 0.0) return std::nullopt;
+        return fill.notional / targetQty_;
+    }
+
+    const Orderbook& book_;
+    double depthPct_;
+    double targetQty_;
+    mutable std::optional<double>                bidDepth_;
+    mutable std::optional<double>                askDepth_;
+    mutable std::optional<std::optional<double>> vwapBuy_;   // outer: computed, inner: fillable
+    mutable std::optional<std::optional<double>> vwapSell_;
+};
+
+std::vector<std::string> parseMetricList(const std::string& list);
+
+// Reads one metric through the view; nullopt only for an unfillable VWAP. Throws
+// std::invalid_argument for a name outside metricNames()
+std::optional<double> readMetric(const LazyStats& stats, const std::string& name);
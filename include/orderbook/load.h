@@ -0,0 +1,79 @@
+#pragma once
+
+#include <exception>
+#include <string_view>
+#include <string>
+#include <vector>
+
+#include "orderbook/types.h"
+#include "orderbook/shape.h"
+
+// CSV (stream, mmap, parallel) and binary snapshot loaders
+
+// Loads into `book`, reusing its capacity: a caller loading many files keeps one
+// Orderbook and the vectors stop reallocating once they fit the largest file.
+void loadCSV(const std::string& filename, const BookShape& shape, Orderbook& book);
+
+Orderbook loadCSV(const std::string& filename, const BookShape& shape = {});
+
+// Read-only mmap of a whole file; unmapped on destruction
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view view() const { return {data_, size_}; }
+
+private:
+    const char* data_ = nullptr;
+    size_t      size_ = 0;
+};
+
+// Output of parsing one newline-aligned byte range of the file
+struct ChunkResult {
+    std::vector<Order> bids;
+    std::vector<Order> asks;
+    int                lines = 0;  // lines consumed, including blank ones
+    std::exception_ptr error;      // first failure, rethrown as-is by the caller
+};
+
+// Per-chunk parse buffers kept between loads (see loadCSVParallel)
+struct LoadBuffers {
+    std::vector<ChunkResult> chunks;
+};
+
+// Parses the mapped file on `threads` workers (0 = all cores). Each worker fills its own
+// bid/ask vectors, which are concatenated before the usual sort and validation.
+// `book` and `buffers` keep their capacity across calls, so thousands of loads in one
+// process settle into zero allocations per file apart from the mapping itself.
+void loadCSVParallel(const std::string& filename, unsigned threads, const BookShape& shape,
+                     Orderbook& book, LoadBuffers& buffers);
+
+Orderbook loadCSVParallel(const std::string& filename, unsigned threads, const BookShape& shape = {});
+
+// loadCSVParallel on CSV text that is already in memory (header line included)
+void parseCSV(std::string_view data, unsigned threads, const BookShape& shape,
+              Orderbook& book, LoadBuffers& buffers);
+
+// Same rules and error messages as loadCSV, but tokenizes the mapped file in place:
+// every field is a string_view into the mapping, so no row allocates.
+Orderbook loadCSVMapped(const std::string& filename);
+
+bool isBinarySnapshot(const std::string& filename);
+
+bool isBinarySnapshotData(std::string_view data);
+
+// Loads a binary snapshot: levels are already sorted, so this is a straight copy
+// out of the mapping with no text parsing and no std::sort.
+void loadBinary(const std::string& filename, const BookShape& shape, Orderbook& book);
+
+Orderbook loadBinary(const std::string& filename, const BookShape& shape = {});
+
+// loadBinary on snapshot bytes already in memory; `filename` only labels errors
+void parseBinary(std::string_view data, const std::string& filename, const BookShape& shape, Orderbook& book);
+
+// CSV -> binary converter: the book is already validated and sorted by the loader
+void saveBinary(const Orderbook& book, const std::string& filename);
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <string_view>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <ostream>
+#include <cmath>
+#include <charconv>
+#include <span>
+#include <array>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+
+#include "orderbook/byte_order.h"
+#include "orderbook/types.h"
+#include "orderbook/calc.h"
+#include "orderbook/profile.h"
+
+// Console tables and machine-readable record output
+
+class ConsolidatedBook;
+struct SlippagePoint;
+struct PriceMovePoint;
+
+void printStats(const Stats& s, double depthPct, double targetQty);
+
+void printDepthCurve(const std::vector<DepthPoint>& curve);
+
+void printImpactCurve(const std::vector<ImpactPoint>& curve);
+
+void printSlippageCapacity(const std::vector<SlippagePoint>& points);
+
+void printPriceMoves(const std::vector<PriceMovePoint>& moves);
+
+// Cross-venue touch, arbitrage and VWAP, plus which venues a targetQty fill would hit
+void printConsolidated(const ConsolidatedBook& book, double targetQty);
+
+enum class OutputFormat { CSV, TSV, JSONL, BINARY };
+
+OutputFormat parseOutputFormat(std::string_view name);
+
+// Binary record stream: "OBR1", u32 numeric column count, each column name as u16
+// length + bytes, and a u8 that is 1 when records carry an error text. Each record is
+// the key (u16 length + bytes), one f64 per column and, if flagged, the error text
+// (u16 length + bytes, empty on success). Little-endian on every host, unpadded.
+constexpr char RECORD_MAGIC[4] = {'O', 'B', 'R', '1'};
+
+// Stats column names, shared by --metrics, stream and batch output
+const std::vector<std::string>& metricNames();
+
+// Stats in metricNames() column order
+std::array<double, 9> statsValues(const Stats& s);
+
+// Formats records with std::to_chars into a 64 KiB buffer and hands the stream one
+// large write per buffer, so per-row cost is formatting only: no iostream state,
+// locale or sentry work per field. Numbers use %.10g, like the previous iostream
+// output; NaN is "nan" in CSV/TSV and null in JSON. CSV quotes a key, column name or
+// error text that holds a ',', '"' or line break (RFC 4180); TSV escapes tab, line
+// breaks and backslash as \t, \n, \r and \\.
+class RecordWriter {
+public:
+    RecordWriter(std::ostream& out, OutputFormat format) : out_(out), format_(format) {
+        buffer_.reserve(BUFFER_BYTES);
+    }
+    ~RecordWriter() { flush(); }
+
+    RecordWriter(const RecordWriter&)            = delete;
+    RecordWriter& operator=(const RecordWriter&) = delete;
+
+    // Declares the key column, the numeric columns and whether rows carry an error text
+    void header(std::string_view keyName, std::span<const std::string> columns, bool withError) {
+        keyName_ = keyName;
+        columns_.assign(columns.begin(), columns.end());
+        withError_ = withError;
+
+        if (format_ == OutputFormat::JSONL) return;
+        if (format_ == OutputFormat::BINARY) {
+            append(std::string_view(RECORD_MAGIC, sizeof(RECORD_MAGIC)));
+            appendRaw(static_cast<uint32_t>(columns_.size()));
+            for (const auto& column : columns_) appendString(column);
+            appendRaw(static_cast<uint8_t>(withError_));
+            return;
+        }
+        appendField(keyName_);
+        for (const auto& column : columns_) {
+            buffer_.push_back(separator());
+            appendField(column);
+        }
+        if (withError_) {
+            buffer_.push_back(separator());
+            buffer_ += "error";
+        }
+        buffer_.push_back('\n');
+    }
+
+    void row(std::string_view key, std::span<const double> values, std::string_view error = {}) {
+        {
+            ProfileScope scope(Stage::OUTPUT);
+            switch (format_) {
+            case OutputFormat::BINARY:
+                appendString(key);
+                for (double v : values) appendRaw(v);
+                if (withError_) appendString(error);
+                break;
+            case OutputFormat::JSONL:
+                buffer_ += "{\"";
+                append(keyName_);
+                buffer_ += "\":";
+                appendJsonString(key);
+                for (size_t i = 0; i < values.size(); i++) {
+                    buffer_ += ",\"";
+                    append(columns_[i]);
+                    buffer_ += "\":";
+                    if (std::isfinite(values[i])) appendNumber(values[i]);
+                    else                          buffer_ += "null";
+                }
+                if (withError_) {
+                    buffer_ += ",\"error\":";
+                    if (error.empty()) buffer_ += "null";
+                    else               appendJsonString(error);
+                }
+                buffer_ += "}\n";
+                break;
+            default:
+                appendField(key);
+                for (double v : values) {
+                    buffer_.push_back(separator());
+                    appendNumber(v);
+                }
+                if (withError_) {
+                    buffer_.push_back(separator());
+                    appendField(error);
+                }
+                buffer_.push_back('\n');
+            }
+        }
+        if (buffer_.size() >= BUFFER_BYTES - 1024) flush();
+    }
+
+    void flush() {
+        ProfileScope scope(Stage::OUTPUT);
+        if (!buffer_.empty()) out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+        out_.flush();
+    }
+
+private:
+    static constexpr size_t BUFFER_BYTES = 64 * 1024;
+
+    char separator() const { return format_ == OutputFormat::TSV ? '\t' : ','; }
+
+    void append(std::string_view text) { buffer_.append(text.data(), text.size()); }
+
+    void appendNumber(double v) {
+        char digits[32];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), v, std::chars_format::general, 10);
+        buffer_.append(digits, end);
+    }
+
+    template <typename T>
+    void appendRaw(T v) {
+        char bytes[sizeof(T)];
+        v = littleEndian(v);
+        std::memcpy(bytes, &v, sizeof(T));
+        buffer_.append(bytes, sizeof(T));
+    }
+
+    // A key, column name or error text of a CSV / TSV row, quoted or escaped only when needed
+    void appendField(std::string_view text) {
+        if (format_ == OutputFormat::TSV) {
+            if (text.find_first_of("\t\n\r\\") == std::string_view::npos) return append(text);
+            for (char c : text) {
+                switch (c) {
+                case '\t': buffer_ += "\\t";  break;
+                case '\n': buffer_ += "\\n";  break;
+                case '\r': buffer_ += "\\r";  break;
+                case '\\': buffer_ += "\\\\"; break;
+                default:   buffer_.push_back(c);
+                }
+            }
+            return;
+        }
+        if (text.find_first_of(",\"\n\r") == std::string_view::npos) return append(text);
+        buffer_.push_back('"');
+        for (char c : text) {
+            if (c == '"') buffer_.push_back('"');
+            buffer_.push_back(c);
+        }
+        buffer_.push_back('"');
+    }
+
+    void appendString(std::string_view text) {
+        appendRaw(static_cast<uint16_t>(std::min<size_t>(text.size(), 0xFFFF)));
+        append(text.substr(0, 0xFFFF));
+    }
+
+    void appendJsonString(std::string_view text) {
+        buffer_.push_back('"');
+        for (char c : text) {
+            if      (c == '"' || c == '\\')             { buffer_.push_back('\\'); buffer_.push_back(c); }
+            else if (static_cast<unsigned char>(c) < 0x20) {
+                char escape[8];
+                std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+                buffer_ += escape;
+            }
+            else buffer_.push_back(c);
+        }
+        buffer_.push_back('"');
+    }
+
+    std::ostream&            out_;
+    OutputFormat             format_;
+    std::string              buffer_;
+    std::string              keyName_;
+    std::vector<std::string> columns_;
+    bool                     withError_ = false;
+};
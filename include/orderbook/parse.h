@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string_view>
+#include <string>
+#include <vector>
+
+#include "orderbook/types.h"
+
+// Allocation-free field and row parsing shared by every loader
+
+std::string_view trimView(std::string_view s);
+
+std::string trim(const std::string& s);
+
+Side parseSide(std::string_view raw);
+
+// Like std::stod, accepts an optional leading '+' and ignores trailing characters
+// after a valid number, but never allocates. `allowZero` admits 0 (level removals).
+double parseDouble(std::string_view raw, std::string_view fieldName, bool allowZero = false);
+
+// Status-returning forms of the two above for hot paths that count bad input instead
+// of reporting it: false on the rows the throwing versions reject, nothing allocated
+bool tryParseSide(std::string_view raw, Side& side) noexcept;
+bool tryParseDouble(std::string_view raw, double& value, bool allowZero = false) noexcept;
+
+// Splits off everything up to the next ',' (same semantics as getline(ss, field, ','))
+std::string_view nextField(std::string_view& rest);
+
+Order parseRow(std::string_view line, int lineNumber);
+
+// Parses a comma-separated list such as "0.1,0.25,0.5"
+std::vector<double> parseDoubleList(std::string_view list, std::string_view fieldName);
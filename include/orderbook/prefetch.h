@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Read-ahead of many small files for batch runs
+
+// One file's bytes, or why it could not be read
+struct PrefetchedFile {
+    size_t      index = 0;  // position in the input list
+    std::string data;
+    std::string error;      // empty on success
+};
+
+// Reads a list of files ahead of the consumers on `readers` background threads, in
+// input order, into at most `depth` buffers. Consumers take whichever file is ready
+// next, parse it from memory and hand the buffer back, so reads overlap parsing and
+// analysis and buffer capacity is reused instead of reallocated per file. Every
+// readers-side wait is on a free buffer, never on a particular consumer, so any
+// number of consumers calling next() exactly files.size() times always completes.
+class FilePrefetcher {
+public:
+    FilePrefetcher(std::vector<std::string> files, unsigned readers, size_t depth);
+    ~FilePrefetcher();
+
+    FilePrefetcher(const FilePrefetcher&)            = delete;
+    FilePrefetcher& operator=(const FilePrefetcher&) = delete;
+
+    // Blocks until a file is ready and moves it into `file`; the caller must
+    // release() it when done. Returns false once every file has been handed out.
+    bool next(PrefetchedFile& file);
+
+    // Returns a consumed file's buffer to the free list
+    void release(PrefetchedFile& file);
+
+    const std::string& filename(size_t index) const { return files_[index]; }
+
+private:
+    void readLoop();
+
+    std::vector<std::string> files_;
+    std::vector<std::thread> readers_;
+
+    std::mutex                 mutex_;
+    std::condition_variable    freed_;   // a buffer returned to the free list
+    std::condition_variable    ready_;   // a file finished reading
+    std::vector<std::string>   free_;    // recycled buffers (keep their capacity)
+    std::deque<PrefetchedFile> done_;
+    size_t                     nextRead_  = 0;  // next file index to claim
+    size_t                     handedOut_ = 0;
+    bool                       stopping_  = false;
+};
+
+// Reads a whole file into `out`, reusing its capacity; false (with `error` set) on failure
+bool readWholeFile(const std::string& filename, std::string& out, std::string& error);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Per-stage timing counters for the analysis pipeline (--profile)
+
+enum class Stage : uint8_t { READ, PARSE, SORT, SOA, DEPTH, VWAP, OUTPUT, COUNT };
+
+constexpr size_t STAGE_COUNT = static_cast<size_t>(Stage::COUNT);
+
+const char* stageName(Stage stage);
+
+// Off by default. While off, a ProfileScope costs one relaxed load and a
+// predictable branch, so the scopes stay compiled into the hot paths.
+inline std::atomic<bool> profilingOn{false};
+
+inline bool profilingEnabled() { return profilingOn.load(std::memory_order_relaxed); }
+
+// Turns the counters on and starts the TSC calibration interval
+void enableProfiling();
+
+// Raw timestamp counter (rdtsc: ~20 cycles, not serializing); steady_clock elsewhere.
+// profileSummary() converts ticks to seconds.
+inline uint64_t readTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Adds one timed call to the calling thread's counter for `stage`
+void profileRecord(Stage stage, uint64_t ticks);
+
+// Times its own lifetime into `stage` when profiling is on
+class ProfileScope {
+public:
+    explicit ProfileScope(Stage stage) : stage_(stage), start_(profilingEnabled() ? readTicks() : 0) {}
+    ~ProfileScope() {
+        if (start_) profileRecord(stage_, readTicks() - start_);
+    }
+
+    ProfileScope(const ProfileScope&)            = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Stage    stage_;
+    uint64_t start_;
+};
+
+struct StageTotals {
+    Stage    stage;
+    double   seconds;  // summed over threads, so parallel stages can exceed wall time
+    uint64_t calls;
+};
+
+struct ProfileSummary {
+    double                   wallSeconds;  // since enableProfiling()
+    size_t                   threads;      // threads that recorded anything
+    std::vector<StageTotals> stages;       // every stage, in Stage order
+};
+
+// Totals of every thread's counters, live or exited. Exact once the profiled work
+// has finished; while threads are still running it is a consistent-enough snapshot.
+ProfileSummary profileSummary();
+
+// Table of profileSummary(): time, share of wall time, calls and time per call
+void printProfile(std::ostream& out);
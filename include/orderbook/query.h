@@ -0,0 +1,54 @@
+#pragma once
+
+#include <span>
+
+#include "orderbook/types.h"
+
+// Embeddable query API over caller-owned level arrays. Every function is noexcept and
+// allocation-free: inputs are spans of best-first levels (bids descending, asks
+// ascending), failures come back as a QueryStatus, and nothing is copied, so a
+// market-data handler can query its own buffers in place on the hot path.
+
+enum class QueryStatus {
+    OK,
+    EMPTY_BOOK,            // a side has no levels
+    CROSSED_BOOK,          // best bid >= best ask
+    NOT_ENOUGH_LIQUIDITY,  // a side cannot fill the requested quantity
+    INVALID_ARGUMENT,      // non-positive or non-finite quantity, negative percentage
+};
+
+// Both sides of a book, best-first. Level is the plain {price, size} layout; Order
+// lets a loaded Orderbook be queried without conversion (see viewOf).
+template <typename L>
+struct BasicBookView {
+    std::span<const L> bids;
+    std::span<const L> asks;
+};
+
+using BookView      = BasicBookView<Level>;
+using OrderbookView = BasicBookView<Order>;
+
+inline OrderbookView viewOf(const Orderbook& book) noexcept {
+    return {book.bids, book.asks};
+}
+
+// Total size of one side priced inside [minPrice, maxPrice]; O(log n + run length)
+double queryDepth(Side side, std::span<const Level> levels, double minPrice, double maxPrice) noexcept;
+double queryDepth(Side side, std::span<const Order> levels, double minPrice, double maxPrice) noexcept;
+
+// VWAP for filling targetQty from the touch outward; `vwap` is written only on OK
+QueryStatus queryVWAP(std::span<const Level> levels, double targetQty, double& vwap) noexcept;
+QueryStatus queryVWAP(std::span<const Order> levels, double targetQty, double& vwap) noexcept;
+
+// VWAP for every target in `sortedQtys` (ascending) in one forward walk, written to
+// `vwaps` (same length). Unfillable targets get NaN and make the result
+// NOT_ENOUGH_LIQUIDITY; the fillable ones are still answered.
+QueryStatus queryVWAPs(std::span<const Level> levels, std::span<const double> sortedQtys,
+                       std::span<double> vwaps) noexcept;
+
+// Every Stats field, as calcStats computes them. On NOT_ENOUGH_LIQUIDITY all fields are
+// filled and the unfillable VWAPs are NaN; on any other failure `out` is untouched.
+QueryStatus queryStats(BookView book, double depthPct, double targetQty, Stats& out) noexcept;
+QueryStatus queryStats(OrderbookView book, double depthPct, double targetQty, Stats& out) noexcept;
+
+const char* queryStatusName(QueryStatus status) noexcept;
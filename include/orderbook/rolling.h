@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "orderbook/types.h"
+
+// Rolling time-series analytics over a stream of Stats
+
+// FIFO over a power-of-two circular buffer. Grows (doubling) only when full, so
+// its size tracks the largest window seen, never the length of the history.
+template <typename T>
+class RingBuffer {
+public:
+    bool   empty() const { return head_ == tail_; }
+    size_t size()  const { return tail_ - head_; }
+
+    const T& front()           const { return slots_[head_ & mask()]; }
+    const T& back()            const { return slots_[(tail_ - 1) & mask()]; }
+    const T& operator[](size_t i) const { return slots_[(head_ + i) & mask()]; }
+
+    void push_back(const T& item) {
+        if (size() == slots_.size()) grow();
+        slots_[tail_++ & mask()] = item;
+    }
+    void pop_front() { head_++; }
+
+private:
+    size_t mask() const { return slots_.size() - 1; }
+
+    void grow() {
+        std::vector<T> bigger(slots_.empty() ? 64 : slots_.size() * 2);
+        for (size_t i = 0; i < size(); i++) bigger[i] = (*this)[i];
+        tail_  = size();
+        head_  = 0;
+        slots_.swap(bigger);
+    }
+
+    std::vector<T> slots_;
+    size_t         head_ = 0;
+    size_t         tail_ = 0;
+};
+
+// Streaming quantiles over positive values with ~1% relative error: log-spaced bins
+// from 1e-8 to 1e8, plus coarse per-block counts so a query scans ~60 blocks and one
+// block of bins instead of every bin. Values are added and removed, so the histogram
+// always describes exactly the current window; memory is fixed (~15 KB).
+class LogHistogram {
+public:
+    static constexpr double   MIN_VALUE = 1e-8;
+    static constexpr double   GROWTH    = 1.01;  // bin width ratio = relative error bound
+    static constexpr uint32_t BINS      = 3712;  // covers MIN_VALUE .. ~1e8; bin 0 holds <= MIN_VALUE
+    static constexpr uint32_t BLOCK     = 64;
+
+    // Bin index for a value (anything below MIN_VALUE, including 0, lands in bin 0)
+    static uint32_t binOf(double value);
+
+    void add(uint32_t bin)    { counts_[bin]++; blocks_[bin / BLOCK]++; total_++; }
+    void remove(uint32_t bin) { counts_[bin]--; blocks_[bin / BLOCK]--; total_--; }
+
+    uint64_t count() const { return total_; }
+
+    // Representative value (geometric bin centre) of the q-quantile, q in [0, 1];
+    // NaN when empty
+    double quantile(double q) const;
+
+private:
+    std::array<uint32_t, BINS>         counts_{};
+    std::array<uint32_t, BINS / BLOCK> blocks_{};
+    uint64_t                           total_ = 0;
+};
+
+// Rolling metrics over the last `window` time units of a Stats series, updated in
+// O(1) amortized per snapshot. Only the snapshots inside the window are kept, as
+// compact samples in a ring buffer; running sums are adjusted on entry and eviction
+// (and re-summed from the ring now and then, so float error cannot build up over
+// months of data). Columns, in values() order (see rollingNames()):
+//   twa_spread        time-weighted average spread over the window
+//   spread_p50/90/99  spread quantiles over the window's snapshots
+//   bid/ask_depth_ewma depth EWMA with time constant `window`
+//   vwap_buy/sell_drift_pct  % change of each VWAP since the oldest snapshot in the window
+//   window_snapshots  snapshots currently inside the window
+// A snapshot's spread holds from its timestamp until the next one. NaN metrics
+// (empty or crossed books, unfillable VWAPs) are skipped by the aggregates that need them.
+class RollingStats {
+public:
+    static constexpr size_t COLUMNS = 9;
+
+    explicit RollingStats(double window);
+
+    // Timestamps must not decrease
+    void add(double time, const Stats& stats);
+
+    std::array<double, COLUMNS> values() const;
+
+    size_t windowSize() const { return samples_.size(); }
+
+private:
+    struct Sample {
+        double   time;
+        double   spread;    // NaN when unavailable
+        double   vwapBuy;
+        double   vwapSell;
+        uint32_t bin;       // histogram bin of spread, valid when spread is not NaN
+    };
+
+    void evict(double cutoff);
+    void resum();
+
+    double window_;
+
+    RingBuffer<Sample> samples_;
+    LogHistogram       spreads_;
+    double             spreadTime_  = 0.0;  // sum of spread * held time over closed intervals
+    double             validTime_   = 0.0;  // total held time of those intervals
+    size_t             sinceResum_  = 0;
+
+    double bidEwma_      = 0.0, askEwma_ = 0.0;
+    double lastEwmaTime_ = 0.0;    // time of the last EWMA update
+    bool   ewmaSet_      = false;
+};
+
+// Column names matching RollingStats::values()
+std::vector<std::string> rollingNames();
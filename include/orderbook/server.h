@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "orderbook/types.h"
+
+// Resident query server: books stay loaded, queries arrive over a Unix socket
+
+// Text protocol, one request per line, fields separated by spaces. Every request gets
+// exactly one reply line: "OK" followed by space-separated values, or "ERR <message>".
+// Numbers are printed like the record writer (%.10g, "nan" when a side is too thin).
+//
+//   LOAD <name> <path>              load (or reload) a book       OK <bid levels> <ask levels>
+//   DROP <name>                     forget a book                 OK
+//   LIST                                                          OK <name>...
+//   STATS <name> <depthPct> <qty>   the nine --stream columns     OK best_bid ... vwap_sell
+//   SPREAD <name>                                                 OK best_bid best_ask mid spread spread_pct
+//   DEPTH <name> <depthPct>                                       OK bid_depth ask_depth
+//   VWAP <name> <qty>                                             OK vwap_buy vwap_sell
+//   IMPACT <name> <qty,qty,...>     per size                      OK buy sell buy sell ...
+//   SLIPPAGE <name> <bps>           max size within bps of mid    OK buy_qty buy_vwap sell_qty sell_vwap
+//   METRICS                         server counters, then --profile stage totals when enabled
+//   PING | QUIT | SHUTDOWN          liveness, close this connection, stop the server
+
+// A loaded book and the indices built from it once, on LOAD. Queries only read the SoA
+// prefix arrays, so depth, VWAP and slippage are binary searches: O(log n) per query.
+struct ResidentBook {
+    Orderbook   book;
+    SoABook     soa;
+    std::string source;  // path it was loaded from
+};
+
+// Loads `path` into `book`, throwing on error (the CLI passes its own loadBook, so
+// --mmap, --threads and the shaping flags apply to every LOAD)
+using BookLoader = std::function<void(const std::string& path, Orderbook& book)>;
+
+// Owns the books and answers requests. handle() is the whole protocol and touches no
+// socket, so it can be driven in-process as well as through SocketServer.
+class BookServer {
+public:
+    explicit BookServer(BookLoader loader) : loader_(std::move(loader)) {}
+
+    void load(const std::string& name, const std::string& path);
+
+    // Appends the reply line (with its '\n') for one request line to `reply`. Returns
+    // false for QUIT and SHUTDOWN; shutdownRequested() tells them apart.
+    bool handle(std::string_view request, std::string& reply);
+
+    bool shutdownRequested() const { return shutdown_; }
+
+private:
+    const ResidentBook& find(std::string_view name) const;
+
+    BookLoader loader_;
+    std::map<std::string, std::unique_ptr<ResidentBook>, std::less<>> books_;
+    uint64_t requests_ = 0;
+    uint64_t errors_   = 0;
+    bool     shutdown_ = false;
+};
+
+// Single-threaded poll() loop over a listening Unix stream socket and its clients.
+// Clients may pipeline requests; each complete line is answered in order and replies
+// that do not fit the socket buffer are queued until it drains. A LOAD blocks every
+// client while it runs; queries take microseconds. A client whose unfinished line grows
+// past MAX_LINE_BYTES gets an ERR and is disconnected.
+class SocketServer {
+public:
+    // Binds and listens on `path`, replacing a stale socket file but never another file
+    SocketServer(BookServer& books, const std::string& path);
+    ~SocketServer();
+
+    SocketServer(const SocketServer&)            = delete;
+    SocketServer& operator=(const SocketServer&) = delete;
+
+    // Waits up to timeoutMs for activity and serves it; false once SHUTDOWN arrived
+    bool poll(int timeoutMs);
+
+private:
+    struct Client {
+        int         fd;
+        std::string input;   // bytes after the last complete line
+        std::string output;  // replies not yet accepted by the socket
+        bool        closing = false;
+    };
+
+    static constexpr size_t MAX_LINE_BYTES = 64 * 1024;  // longest pending request line
+
+    void accept();
+    bool readFrom(Client& client);  // false when the peer hung up
+    bool writeTo(Client& client);   // false on a broken connection
+
+    BookServer&         books_;
+    std::string         path_;
+    int                 listener_ = -1;
+    std::vector<Client> clients_;
+};
+
+// Client side of --query: sends each line of `requests` and copies every reply to `out`
+void queryServer(const std::string& path, std::istream& requests, std::ostream& out);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+#include "orderbook/types.h"
+
+// Post-load book shaping: sorting, level aggregation, top-N and price-band cuts
+
+// How a loaded book is reduced before analysis
+struct BookShape {
+    bool   aggregate = false;  // merge rows at the same price into one level
+    double bucket    = 0.0;    // when > 0, snap prices to this coarser tick first
+    size_t topLevels = 0;      // when > 0, keep only the best N levels per side
+    double bandPct   = 0.0;    // when > 0, keep only levels within this % of the touch
+};
+
+// Collapses runs of equal price in a sorted side into one level holding their total size
+void mergeEqualPrices(std::vector<Order>& orders);
+
+// Applies a BookShape to an already sorted book
+void shapeBook(Orderbook& book, const BookShape& shape);
+
+// Rejects empty or crossed books; `book` must already be sorted best-first
+void validateBook(const Orderbook& book);
+
+// Sorts both sides, applies the shape and rejects empty or crossed books
+void finalizeBook(Orderbook& book, const BookShape& shape = {});
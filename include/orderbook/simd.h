@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+// Runtime-dispatched SIMD kernels for the depth sum and the fill walk
+
+struct SimdKernels {
+    const char* name;
+    double (*depth)(const double*, const double*, size_t, double, double);
+    double (*fill) (const double*, const double*, size_t, double, double&);
+};
+
+// Kernel sets the running CPU supports, best first; scalar is always last
+const std::vector<SimdKernels>& availableKernels();
+
+const SimdKernels& activeKernels();
+
+// "auto" picks the best supported set; a name forces that set (for comparisons)
+void selectKernels(std::string_view name);
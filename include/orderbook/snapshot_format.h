@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "orderbook/byte_order.h"
+
+// Binary snapshot layout (little-endian, no padding between sections):
+//   SnapshotHeader
+//   SnapshotLevel bids[bidCount]   — sorted by price, descending
+//   SnapshotLevel asks[askCount]   — sorted by price, ascending
+// Readers rely on the sort order and never re-sort.
+
+constexpr char     SNAPSHOT_MAGIC[4] = {'O', 'B', 'K', '1'};
+constexpr uint32_t SNAPSHOT_VERSION  = 1;
+
+struct SnapshotHeader {
+    char     magic[4];
+    uint32_t version;
+    uint64_t bidCount;
+    uint64_t askCount;
+};
+
+struct SnapshotLevel {
+    double price;
+    double size;
+};
+
+static_assert(sizeof(SnapshotHeader) == 24, "SnapshotHeader must stay packed");
+static_assert(sizeof(SnapshotLevel)  == 16, "SnapshotLevel must stay packed");
+
+// Swaps every field between host and file byte order (see littleEndian)
+inline SnapshotHeader littleEndian(SnapshotHeader header) {
+    header.version  = littleEndian(header.version);
+    header.bidCount = littleEndian(header.bidCount);
+    header.askCount = littleEndian(header.askCount);
+    return header;
+}
+
+inline SnapshotLevel littleEndian(SnapshotLevel level) {
+    return {littleEndian(level.price), littleEndian(level.size)};
+}
+
+inline bool hasSnapshotMagic(const char* data, size_t size) {
+    return size >= sizeof(SNAPSHOT_MAGIC) &&
+           std::memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0;
+}
+
+// Caller guarantees bids are sorted descending and asks ascending
+inline void writeSnapshot(const std::string& filename,
+                          const std::vector<SnapshotLevel>& bids,
+                          const std::vector<SnapshotLevel>& asks) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Cannot open file for writing: '" + filename + "'");
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version  = SNAPSHOT_VERSION;
+    header.bidCount = bids.size();
+    header.askCount = asks.size();
+    header = littleEndian(header);
+
+    auto writeLevels = [&](const std::vector<SnapshotLevel>& levels) {
+        if constexpr (std::endian::native == std::endian::little) {
+            file.write(reinterpret_cast<const char*>(levels.data()), levels.size() * sizeof(SnapshotLevel));
+        } else {
+            for (SnapshotLevel level : levels) {
+                level = littleEndian(level);
+                file.write(reinterpret_cast<const char*>(&level), sizeof(level));
+            }
+        }
+    };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeLevels(bids);
+    writeLevels(asks);
+    if (!file)
+        throw std::runtime_error("Failed writing snapshot: '" + filename + "'");
+}
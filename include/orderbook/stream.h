@@ -0,0 +1,24 @@
+#pragma once
+
+#include <istream>
+
+#include "orderbook/history.h"
+#include "orderbook/output.h"
+#include "orderbook/rolling.h"
+#include "orderbook/shape.h"
+
+// Multi-snapshot streaming analysis
+
+// Reads many snapshots from one stream and writes one stats row per snapshot, holding
+// only the current book (its buffers are reused). Two input layouts are accepted:
+//   timestamp,side,price,size   — a snapshot is a run of rows sharing a timestamp
+//   side,price,size             — a row starting with '#' ends the current snapshot;
+//                                 the rest of that row labels the next one
+// When `rolling` is given, each row also carries its rolling columns; when `history`
+// is given, every shaped snapshot and its stats are appended to it as well. A
+// snapshot's time is its label when numeric (an integer for `history`), otherwise
+// its 1-based ordinal.
+// Returns the number of snapshots written.
+size_t streamSnapshots(std::istream& in, RecordWriter& out, double depthPct, double targetQty,
+                       const BookShape& shape = {}, RollingStats* rolling = nullptr,
+                       HistoryWriter* history = nullptr);
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Core order book types and the compile-time side / price policies
+
+enum class Side { BID, ASK };
+
+struct Order {
+    Side   side;
+    double price;
+    double size;
+};
+
+// Compile-time side policy. Every side is stored best-first, so walks never branch on
+// direction; the policy only decides what "better" means (sorting, searching) and
+// names the taker action in errors.
+template <Side S>
+struct SideTraits {
+    static constexpr bool        isBid       = (S == Side::BID);
+    static constexpr const char* takerAction = isBid ? "sell" : "buy";  // taking bids = selling
+
+    template <typename Price>
+    static constexpr bool better(Price a, Price b) { return isBid ? a > b : a < b; }
+};
+
+// Numeric policy for a price/size type: what notional sums accumulate in
+template <typename Price>
+struct PriceTraits {
+    using Accum = double;
+    static double toDouble(Accum v) { return v; }
+};
+
+// Integer ticks/lots: notionals accumulate exactly in 128 bits
+template <>
+struct PriceTraits<int64_t> {
+    using Accum = __int128;
+    static double toDouble(Accum v) { return static_cast<double>(v); }
+};
+
+// Sorts orders best-first for side S
+template <Side S>
+struct BestFirst {
+    bool operator()(const Order& a, const Order& b) const {
+        return SideTraits<S>::better(a.price, b.price);
+    }
+};
+
+// Invariant: after loadCSV, bids are sorted descending and asks ascending,
+// so [0] is always the best price on each side.
+struct Orderbook {
+    std::vector<Order> bids;
+    std::vector<Order> asks;
+};
+
+// Structure-of-arrays copy of one side, same best-first order as the Orderbook vectors.
+// Prefix arrays have size()+1 entries: cumSize[i] / cumNotional[i] are the totals of
+// levels [0, i), so any contiguous range sums to a single subtraction.
+struct BookSide {
+    std::vector<double> prices;
+    std::vector<double> sizes;
+    std::vector<double> cumSize;
+    std::vector<double> cumNotional;
+
+    size_t size() const { return prices.size(); }
+};
+
+struct SoABook {
+    BookSide bids;  // descending by price
+    BookSide asks;  // ascending by price
+};
+
+struct Stats {
+    double bestBid;
+    double bestAsk;
+    double midPrice;
+    double spread;
+    double spreadPct;
+    double bidDepth;
+    double askDepth;
+    double vwapBuy;
+    double vwapSell;
+};
+
+// A price level without a side tag: the element type of the span query API and of
+// the incremental book
+struct Level {
+    double price;
+    double size;
+};
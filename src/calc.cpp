@@ -0,0 +1,158 @@
+#include "orderbook/calc.h"
+
+#include "orderbook/profile.h"
+#include "orderbook/simd.h"
+
+#include <limits>
+
+double calcDepth(const std::vector<Order>& orders, double minPrice, double maxPrice) {
+    ProfileScope scope(Stage::DEPTH);
+    double total = 0.0;
+    for (const auto& order : orders)
+        if (order.price >= minPrice && order.price <= maxPrice)
+            total += order.size;
+    return total;
+}
+
+double calcVWAPBuy(const std::vector<Order>& asks, double targetQty) {
+    ProfileScope scope(Stage::VWAP);
+    return calcVWAP<Side::ASK>(asks, targetQty);
+}
+
+double calcVWAPSell(const std::vector<Order>& bids, double targetQty) {
+    ProfileScope scope(Stage::VWAP);
+    return calcVWAP<Side::BID>(bids, targetQty);
+}
+
+void assignBookSide(const std::vector<Order>& orders, BookSide& side) {
+    ProfileScope scope(Stage::SOA);
+    side.prices.resize(orders.size());
+    side.sizes.resize(orders.size());
+    side.cumSize.resize(orders.size() + 1);
+    side.cumNotional.resize(orders.size() + 1);
+
+    side.cumSize[0] = side.cumNotional[0] = 0.0;
+    for (size_t i = 0; i < orders.size(); i++) {
+        side.prices[i]          = orders[i].price;
+        side.sizes[i]           = orders[i].size;
+        side.cumSize[i + 1]     = side.cumSize[i]     + orders[i].size;
+        side.cumNotional[i + 1] = side.cumNotional[i] + orders[i].size * orders[i].price;
+    }
+}
+
+BookSide toBookSide(const std::vector<Order>& orders) {
+    BookSide side;
+    assignBookSide(orders, side);
+    return side;
+}
+
+SoABook toSoA(const Orderbook& book) {
+    return SoABook{toBookSide(book.bids), toBookSide(book.asks)};
+}
+
+void toSoA(const Orderbook& book, SoABook& out) {
+    assignBookSide(book.bids, out.bids);
+    assignBookSide(book.asks, out.asks);
+}
+
+double calcDepth(const BookSide& side, double minPrice, double maxPrice) {
+    ProfileScope scope(Stage::DEPTH);
+    return activeKernels().depth(side.prices.data(), side.sizes.data(), side.size(), minPrice, maxPrice);
+}
+
+std::vector<DepthPoint> calcDepthCurve(const SoABook& book, const std::vector<double>& depthPcts) {
+    ProfileScope scope(Stage::DEPTH);
+    double mid = (book.bids.prices[0] + book.asks.prices[0]) / 2.0;
+    std::vector<DepthPoint> curve;
+    curve.reserve(depthPcts.size());
+    for (double pct : depthPcts) {
+        double lower = mid * (1.0 - pct / 100.0);
+        double upper = mid * (1.0 + pct / 100.0);
+        curve.push_back({pct,
+                         calcDepthIndexed<Side::BID>(book.bids, lower, upper),
+                         calcDepthIndexed<Side::ASK>(book.asks, lower, upper)});
+    }
+    return curve;
+}
+
+double fillNotional(const BookSide& side, double targetQty, double& remaining) {
+    ProfileScope scope(Stage::VWAP);
+    return activeKernels().fill(side.prices.data(), side.sizes.data(), side.size(), targetQty, remaining);
+}
+
+double calcVWAPBuy (const BookSide& asks, double targetQty) { return calcVWAP<Side::ASK>(asks, targetQty); }
+
+double calcVWAPSell(const BookSide& bids, double targetQty) { return calcVWAP<Side::BID>(bids, targetQty); }
+
+std::vector<double> calcVWAPBatch(const BookSide& side, const std::vector<double>& sortedQtys) {
+    ProfileScope scope(Stage::VWAP);
+    if (!std::is_sorted(sortedQtys.begin(), sortedQtys.end()))
+        throw std::invalid_argument("Batch VWAP quantities must be sorted ascending.");
+
+    std::vector<double> vwaps(sortedQtys.size(), std::numeric_limits<double>::quiet_NaN());
+    size_t level = 0;
+    for (size_t k = 0; k < sortedQtys.size(); k++) {
+        double qty = sortedQtys[k];
+        while (level < side.size() && side.cumSize[level + 1] < qty) level++;
+        if (level == side.size()) break; // this and every larger target are unfillable
+        if (qty <= 0.0) continue;
+
+        double partial = (qty - side.cumSize[level]) * side.prices[level];
+        vwaps[k] = (side.cumNotional[level] + partial) / qty;
+    }
+    return vwaps;
+}
+
+std::vector<ImpactPoint> calcImpactCurve(const SoABook& book, const std::vector<double>& sortedQtys) {
+    double mid = (book.bids.prices[0] + book.asks.prices[0]) / 2.0;
+    std::vector<double> buys  = calcVWAPBatch(book.asks, sortedQtys);
+    std::vector<double> sells = calcVWAPBatch(book.bids, sortedQtys);
+
+    std::vector<ImpactPoint> curve(sortedQtys.size());
+    for (size_t k = 0; k < sortedQtys.size(); k++)
+        curve[k] = {sortedQtys[k], buys[k], sells[k],
+                    (buys[k] - mid) / mid * 100.0, (mid - sells[k]) / mid * 100.0};
+    return curve;
+}
+
+void calcTopOfBook(const SoABook& book, double depthPct, Stats& s) {
+    ProfileScope scope(Stage::DEPTH);
+    s.bestBid   = book.bids.prices[0];
+    s.bestAsk   = book.asks.prices[0];
+    s.midPrice  = (s.bestBid + s.bestAsk) / 2.0;
+    s.spread    = s.bestAsk - s.bestBid;
+    s.spreadPct = (s.spread / s.midPrice) * 100.0;
+
+    double lower = s.midPrice * (1.0 - depthPct / 100.0);
+    double upper = s.midPrice * (1.0 + depthPct / 100.0);
+    s.bidDepth  = calcDepthIndexed<Side::BID>(book.bids, lower, upper);
+    s.askDepth  = calcDepthIndexed<Side::ASK>(book.asks, lower, upper);
+}
+
+Stats calcStats(const SoABook& book, double depthPct, double targetQty) {
+    Stats s;
+    calcTopOfBook(book, depthPct, s);
+
+    s.vwapBuy   = calcVWAPBuy (book.asks, targetQty);
+    s.vwapSell  = calcVWAPSell(book.bids, targetQty);
+
+    return s;
+}
+
+Stats calcStatsNoThrow(const SoABook& book, double depthPct, double targetQty) {
+    Stats s;
+    calcTopOfBook(book, depthPct, s);
+
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+    double remaining = 0.0;
+    double cost      = fillNotional(book.asks, targetQty, remaining);
+    s.vwapBuy        = remaining > 0.0 ? NaN : cost / targetQty;
+    double revenue   = fillNotional(book.bids, targetQty, remaining);
+    s.vwapSell       = remaining > 0.0 ? NaN : revenue / targetQty;
+
+    return s;
+}
+
+Stats calcStats(const Orderbook& book, double depthPct, double targetQty) {
+    return calcStats(toSoA(book), depthPct, targetQty);
+}
@@ -0,0 +1,169 @@
+#include "orderbook/consolidated.h"
+
+#include "orderbook/calc.h"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+namespace {
+
+// Best-first order for side S; equal prices fall back to venue id so every
+// (price, venue) pair has exactly one position
+template <Side S>
+struct VenueFirst {
+    bool operator()(const VenueLevel& a, const VenueLevel& b) const {
+        if (a.price != b.price) return SideTraits<S>::better(a.price, b.price);
+        return a.venue < b.venue;
+    }
+};
+
+// The stored (worst-first) order: the exact reverse of VenueFirst
+template <Side S>
+struct VenueLast {
+    bool operator()(const VenueLevel& a, const VenueLevel& b) const { return VenueFirst<S>()(b, a); }
+};
+
+template <Side S>
+const std::vector<Order>& sideOf(const Orderbook& book) {
+    return SideTraits<S>::isBid ? book.bids : book.asks;
+}
+
+// k-way merge of the venues' sorted sides through a heap of per-venue cursors:
+// O(M log k) for M levels across k venues. Emits best-first, then flips to storage order.
+template <Side S>
+void mergeVenues(std::span<const Orderbook> books, std::vector<VenueLevel>& out) {
+    struct Cursor {
+        uint32_t venue;
+        size_t   pos;
+    };
+    auto level = [&](const Cursor& c) {
+        const Order& o = sideOf<S>(books[c.venue])[c.pos];
+        return VenueLevel{o.price, o.size, c.venue};
+    };
+    // priority_queue pops the largest, so "worse" sorts to the bottom
+    auto worse = [&](const Cursor& a, const Cursor& b) { return VenueFirst<S>()(level(b), level(a)); };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(worse)> heap(worse);
+
+    size_t total = 0;
+    for (uint32_t v = 0; v < books.size(); v++) {
+        total += sideOf<S>(books[v]).size();
+        if (!sideOf<S>(books[v]).empty()) heap.push({v, 0});
+    }
+    out.clear();
+    out.reserve(total);
+    while (!heap.empty()) {
+        Cursor c = heap.top();
+        heap.pop();
+        out.push_back(level(c));
+        if (++c.pos < sideOf<S>(books[c.venue]).size()) heap.push(c);
+    }
+    std::reverse(out.begin(), out.end());
+}
+
+// Drops `venue` from a merged side and merges its new sorted levels back in: O(M)
+template <Side S>
+void replaceSide(std::vector<VenueLevel>& side, uint32_t venue, const std::vector<Order>& levels) {
+    std::erase_if(side, [venue](const VenueLevel& l) { return l.venue == venue; });
+
+    std::vector<VenueLevel> incoming(levels.size());
+    std::transform(levels.rbegin(), levels.rend(), incoming.begin(),
+                   [venue](const Order& o) { return VenueLevel{o.price, o.size, venue}; });
+
+    std::vector<VenueLevel> merged(side.size() + incoming.size());
+    std::merge(side.begin(), side.end(), incoming.begin(), incoming.end(), merged.begin(), VenueLast<S>());
+    side.swap(merged);
+}
+
+template <Side S>
+void applySide(std::vector<VenueLevel>& side, uint32_t venue, double price, double size) {
+    VenueLevel key{price, size, venue};
+    auto it = std::lower_bound(side.begin(), side.end(), key, VenueLast<S>());
+    bool exists = it != side.end() && it->price == price && it->venue == venue;
+
+    if (size == 0.0) {
+        if (exists) side.erase(it);
+    } else if (exists) {
+        it->size = size;
+    } else {
+        side.insert(it, key);
+    }
+}
+
+} // namespace
+
+uint32_t ConsolidatedBook::addVenue(std::string name) {
+    names_.push_back(std::move(name));
+    return static_cast<uint32_t>(names_.size() - 1);
+}
+
+void ConsolidatedBook::build(std::span<const Orderbook> books) {
+    if (books.size() != names_.size())
+        throw std::invalid_argument("Expected one book per venue (" + std::to_string(names_.size()) +
+                                    "), got " + std::to_string(books.size()) + ".");
+    mergeVenues<Side::BID>(books, bids_);
+    mergeVenues<Side::ASK>(books, asks_);
+}
+
+void ConsolidatedBook::replaceVenue(uint32_t venue, const Orderbook& book) {
+    replaceSide<Side::BID>(bids_, venue, book.bids);
+    replaceSide<Side::ASK>(asks_, venue, book.asks);
+}
+
+void ConsolidatedBook::apply(uint32_t venue, const LevelUpdate& update) {
+    if (update.side == Side::BID) applySide<Side::BID>(bids_, venue, update.price, update.size);
+    else                          applySide<Side::ASK>(asks_, venue, update.price, update.size);
+}
+
+ConsolidatedStats ConsolidatedBook::stats(double targetQty) const {
+    if (bids_.empty()) throw std::runtime_error("Consolidated book has no bids.");
+    if (asks_.empty()) throw std::runtime_error("Consolidated book has no asks.");
+
+    auto bids = this->bids();
+    auto asks = this->asks();
+
+    ConsolidatedStats s;
+    s.bestBid      = bids[0].price;
+    s.bestBidVenue = bids[0].venue;
+    s.bestAsk      = asks[0].price;
+    s.bestAskVenue = asks[0].venue;
+    s.midPrice     = (s.bestBid + s.bestAsk) / 2.0;
+    s.spread       = s.bestAsk - s.bestBid;
+    s.spreadPct    = (s.spread / s.midPrice) * 100.0;
+
+    // Cross the touch like a matching engine would: pair the cheapest asks with the
+    // richest bids while they overlap. Each venue is uncrossed on its own, so every
+    // pair spans two venues.
+    s.arbQty = s.arbProfit = 0.0;
+    size_t b = 0, a = 0;
+    double bidLeft = bids[0].size, askLeft = asks[0].size;
+    while (b < bids.size() && a < asks.size() && asks[a].price < bids[b].price) {
+        double qty   = std::min(bidLeft, askLeft);
+        s.arbQty    += qty;
+        s.arbProfit += qty * (bids[b].price - asks[a].price);
+        bidLeft     -= qty;
+        askLeft     -= qty;
+        if (bidLeft <= 0.0 && ++b < bids.size()) bidLeft = bids[b].size;
+        if (askLeft <= 0.0 && ++a < asks.size()) askLeft = asks[a].size;
+    }
+
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+    auto buy  = fillLevels(asks, targetQty);
+    auto sell = fillLevels(bids, targetQty);
+    s.vwapBuy  = buy.remaining  > 0.0 ? NaN : buy.notional  / targetQty;
+    s.vwapSell = sell.remaining > 0.0 ? NaN : sell.notional / targetQty;
+    return s;
+}
+
+double ConsolidatedBook::fillByVenue(Side side, double targetQty, std::vector<double>& perVenue) const {
+    perVenue.assign(names_.size(), 0.0);
+    double remaining = targetQty;
+    for (const auto& level : std::views::reverse(side == Side::BID ? bids_ : asks_)) {
+        if (remaining <= 0.0) break;
+        double filled = std::min(remaining, level.size);
+        perVenue[level.venue] += filled;
+        remaining             -= filled;
+    }
+    return remaining;
+}
@@ -0,0 +1,50 @@
+#include "orderbook/cost.h"
+
+#include "orderbook/profile.h"
+
+CostPoint costForQty(const BookSide& side, double qty) {
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+    if (!(qty > 0.0)) return {0.0, 0.0, NaN, true};
+
+    double total = side.cumSize.back();
+    if (qty > total) {
+        double notional = side.cumNotional.back();
+        return {total, notional, total > 0.0 ? notional / total : NaN, false};
+    }
+    // First boundary holding at least qty; the fill ends inside the level just before it
+    size_t k = std::lower_bound(side.cumSize.begin(), side.cumSize.end(), qty) - side.cumSize.begin();
+    double notional = side.cumNotional[k - 1] + (qty - side.cumSize[k - 1]) * side.prices[k - 1];
+    return {qty, notional, notional / qty, true};
+}
+
+std::vector<SlippagePoint> calcSlippageCapacity(const SoABook& book, const std::vector<double>& bpsLimits) {
+    ProfileScope scope(Stage::VWAP);
+    double mid = (book.bids.prices[0] + book.asks.prices[0]) / 2.0;
+
+    std::vector<SlippagePoint> points;
+    points.reserve(bpsLimits.size());
+    for (double bps : bpsLimits) {
+        double buyQty  = maxQtyWithin<Side::ASK>(book.asks, mid, bps);
+        double sellQty = maxQtyWithin<Side::BID>(book.bids, mid, bps);
+        points.push_back({bps, buyQty, costForQty(book.asks, buyQty).vwap,
+                          sellQty, costForQty(book.bids, sellQty).vwap});
+    }
+    return points;
+}
+
+std::vector<PriceMovePoint> calcPriceMoves(const SoABook& book, const std::vector<double>& prices) {
+    ProfileScope scope(Stage::VWAP);
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+    std::vector<PriceMovePoint> moves;
+    moves.reserve(prices.size());
+    for (double price : prices) {
+        if (price > book.asks.prices[0])
+            moves.push_back({price, Side::ASK, costToReach<Side::ASK>(book.asks, price)});
+        else if (price < book.bids.prices[0])
+            moves.push_back({price, Side::BID, costToReach<Side::BID>(book.bids, price)});
+        else
+            moves.push_back({price, Side::ASK, {0.0, 0.0, NaN, true}});
+    }
+    return moves;
+}
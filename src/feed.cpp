@@ -0,0 +1,121 @@
+#include "orderbook/feed.h"
+
+#include "orderbook/parse.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+FeedPipeline::FeedPipeline(const FeedConfig& config, const Orderbook& snapshot)
+    : config_(config), book_(config.depthPct) {
+    book_.reserve(config.reserveLevels);
+    if (!snapshot.bids.empty() || !snapshot.asks.empty()) book_.reset(snapshot);
+
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ < 0) throw std::runtime_error("Cannot create UDP socket.");
+
+    int rcvbuf = 8 << 20;  // absorb bursts while the book thread catches up
+    ::setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    timeval timeout{0, 100000};  // recv wakes every 100 ms so stop() is noticed
+    ::setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(config.port);
+    if (::bind(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(socket_);
+        throw std::runtime_error("Cannot bind UDP port " + std::to_string(config.port) + ".");
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(socket_, reinterpret_cast<sockaddr*>(&addr), &len);
+    boundPort_ = ntohs(addr.sin_port);
+
+    publish(0);
+}
+
+FeedPipeline::~FeedPipeline() {
+    stop();
+    if (socket_ >= 0) ::close(socket_);
+}
+
+void FeedPipeline::start() {
+    if (running_.exchange(true)) return;
+    bookThread_ = std::thread([this] { bookLoop(); });
+    network_    = std::thread([this] { receiveLoop(); });
+}
+
+void FeedPipeline::stop() {
+    if (!running_.exchange(false)) return;
+    if (network_.joinable())    network_.join();
+    if (bookThread_.joinable()) bookThread_.join();
+}
+
+void FeedPipeline::receiveLoop() {
+    char buffer[65536];
+    while (running_.load(std::memory_order_relaxed)) {
+        ssize_t received = ::recv(socket_, buffer, sizeof(buffer), 0);
+        if (received <= 0) continue;  // timeout or signal: re-check running_
+        int64_t now = steadyNanos();
+
+        std::string_view rest(buffer, static_cast<size_t>(received));
+        while (!rest.empty()) {
+            size_t eol = rest.find('\n');
+            std::string_view line = rest.substr(0, eol);
+            rest = eol == std::string_view::npos ? std::string_view{} : rest.substr(eol + 1);
+            if (trimView(line).empty()) continue;
+
+            FeedMessage message{{}, now};
+            if (!tryParseUpdateRow(line, message.update)) {
+                parseErrors_.fetch_add(1, std::memory_order_relaxed);  // dropped, reported per snapshot
+                continue;
+            }
+            // A full ring means the book thread is behind: wait rather than drop, since
+            // a lost delta would leave the book permanently wrong
+            while (!ring_.tryPush(message))
+                if (!running_.load(std::memory_order_relaxed)) return;
+        }
+    }
+}
+
+void FeedPipeline::bookLoop() {
+    FeedMessage message;
+    while (running_.load(std::memory_order_relaxed)) {
+        if (!ring_.tryPop(message)) {
+            std::this_thread::yield();
+            continue;
+        }
+        // Drain whatever has queued up, then publish once for the whole batch
+        int64_t lastRecv = message.recvNanos;
+        do {
+            book_.apply(message.update);
+            updates_++;
+            lastRecv = message.recvNanos;
+        } while (ring_.tryPop(message));
+        publish(lastRecv);
+    }
+}
+
+void FeedPipeline::publish(int64_t recvNanos) {
+    FeedSnapshot snapshot{};
+    snapshot.valid        = book_.tryStats(config_.targetQty, snapshot.stats) ? 1 : 0;
+    snapshot.updates      = updates_;
+    snapshot.parseErrors  = parseErrors_.load(std::memory_order_relaxed);
+    snapshot.latencyNanos = recvNanos ? steadyNanos() - recvNanos : 0;
+    published_.store(snapshot);
+}
@@ -0,0 +1,85 @@
+#include "orderbook/fixed.h"
+
+#include "orderbook/calc.h"
+
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <type_traits>
+
+namespace {
+
+// Coarsest power-of-ten increment (1 down to 1e-9) on which every value lies
+template <typename Get>
+double inferIncrement(const Orderbook& book, Get get, const char* what) {
+    double increment = 1.0;
+    for (int decimals = 0; decimals <= 9; decimals++, increment /= 10.0) {
+        auto onGrid = [&](const Order& o) {
+            double units = get(o) / increment;
+            return std::abs(units - std::round(units)) <= 1e-6;
+        };
+        if (std::all_of(book.bids.begin(), book.bids.end(), onGrid) &&
+            std::all_of(book.asks.begin(), book.asks.end(), onGrid))
+            return increment;
+    }
+    throw std::runtime_error(std::string("Cannot infer ") + what + " size; pass it explicitly.");
+}
+
+int64_t toUnits(double value, double increment, const char* what) {
+    double units = value / increment;
+    double whole = std::round(units);
+    if (std::abs(units - whole) > 1e-6 || !(std::abs(whole) < 9e15))
+        throw std::runtime_error(
+            std::string("Value ") + std::to_string(value) + " is not a multiple of the " +
+            what + " size " + std::to_string(increment) + "."
+        );
+    return static_cast<int64_t>(whole);
+}
+
+} // namespace
+
+FixedBook toFixed(const Orderbook& book, double tickSize, double lotSize) {
+    FixedBook fixed;
+    fixed.tickSize = tickSize > 0.0 ? tickSize : inferIncrement(book, [](const Order& o) { return o.price; }, "tick");
+    fixed.lotSize  = lotSize  > 0.0 ? lotSize  : inferIncrement(book, [](const Order& o) { return o.size;  }, "lot");
+
+    auto convert = [&](const std::vector<Order>& orders, std::vector<FixedOrder>& out) {
+        out.resize(orders.size());
+        for (size_t i = 0; i < orders.size(); i++)
+            out[i] = {toUnits(orders[i].price, fixed.tickSize, "tick"),
+                      toUnits(orders[i].size,  fixed.lotSize,  "lot")};
+    };
+    convert(book.bids, fixed.bids);
+    convert(book.asks, fixed.asks);
+    return fixed;
+}
+
+Stats calcStatsFixed(const FixedBook& book, double depthPct, double targetQty) {
+    int64_t bestBid = book.bids[0].price;
+    int64_t bestAsk = book.asks[0].price;
+    double  midTicks = (bestBid + bestAsk) / 2.0;
+
+    Stats s;
+    s.bestBid   = bestBid * book.tickSize;
+    s.bestAsk   = bestAsk * book.tickSize;
+    s.midPrice  = midTicks * book.tickSize;
+    s.spread    = (bestAsk - bestBid) * book.tickSize;
+    s.spreadPct = (bestAsk - bestBid) / midTicks * 100.0;
+
+    int64_t lowerTick = static_cast<int64_t>(std::ceil (midTicks * (1.0 - depthPct / 100.0)));
+    int64_t upperTick = static_cast<int64_t>(std::floor(midTicks * (1.0 + depthPct / 100.0)));
+    s.bidDepth  = calcDepthRun<Side::BID>(book.bids, lowerTick, upperTick) * book.lotSize;
+    s.askDepth  = calcDepthRun<Side::ASK>(book.asks, lowerTick, upperTick) * book.lotSize;
+
+    int64_t targetLots = toUnits(targetQty, book.lotSize, "lot");
+    auto vwapOf = [&](const auto& levels, auto side) {
+        constexpr Side S = decltype(side)::value;
+        auto fill = fillLevels(levels, targetLots);
+        if (fill.remaining > 0) throwNotEnoughLiquidity<S>(targetQty);
+        return PriceTraits<int64_t>::toDouble(fill.notional) / targetLots * book.tickSize;
+    };
+    s.vwapBuy   = vwapOf(book.asks, std::integral_constant<Side, Side::ASK>());
+    s.vwapSell  = vwapOf(book.bids, std::integral_constant<Side, Side::BID>());
+    return s;
+}
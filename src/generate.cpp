@@ -0,0 +1,289 @@
+#include "orderbook/generate.h"
+
+#include "orderbook/snapshot_format.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Rows are produced in fixed-size chunks. Each chunk has its own RNG seeded from the
+// run seed and the chunk id, so the output is identical for any thread count.
+constexpr int ROWS_PER_CHUNK = 1 << 16;
+constexpr int MAX_ROW_CHARS  = 96;    // generous bound for "timestamp,side,price,size\n"
+
+struct GeneratedBook {
+    std::vector<SnapshotLevel> bids;  // best (highest) first
+    std::vector<SnapshotLevel> asks;  // best (lowest) first
+};
+
+// xoshiro256** (Blackman & Vigna): several times faster than mt19937_64
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    explicit Xoshiro256(uint64_t seed) {
+        for (auto& word : state_) word = splitmix64(seed);
+    }
+
+    result_type operator()() {
+        uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+
+    static uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    uint64_t state_[4];
+};
+
+uint64_t runSeed(const GeneratorConfig& cfg) {
+    if (cfg.seed) return *cfg.seed;
+    static const uint64_t entropy = [] {
+        std::random_device rd;
+        return (uint64_t(rd()) << 32) ^ rd();
+    }();
+    return entropy;
+}
+
+uint64_t chunkSeed(const GeneratorConfig& cfg, uint64_t chunkId) {
+    uint64_t x = runSeed(cfg) ^ (chunkId * 0xD1B54A32D192ED03ull);
+    return Xoshiro256::splitmix64(x);
+}
+
+// Runs fn(engine) with the configured engine type seeded for one chunk
+template <typename Fn>
+void withChunkRng(const GeneratorConfig& cfg, uint64_t chunkId, Fn&& fn) {
+    if (cfg.rng == RngKind::XOSHIRO) {
+        Xoshiro256 engine(chunkSeed(cfg, chunkId));
+        fn(engine);
+    } else {
+        std::mt19937_64 engine(chunkSeed(cfg, chunkId));
+        fn(engine);
+    }
+}
+
+// The engines are fully specified by the standard/their papers, but std::*_distribution
+// is implementation-defined. All sampling below is spelled out so a seed produces the
+// same book with any standard library.
+template <typename Rng>
+double uniform01(Rng& rng) {
+    return double(rng() >> 11) * 0x1.0p-53;  // [0, 1)
+}
+
+template <typename Rng>
+double sampleSize(const GeneratorConfig& cfg, Rng& rng) {
+    switch (cfg.sizeModel) {
+    case SizeModel::LOGNORMAL: {
+        // Box-Muller normal; the median of the lognormal sits at the middle of [min, max]
+        double u1 = 1.0 - uniform01(rng), u2 = uniform01(rng);
+        double z  = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * std::numbers::pi * u2);
+        double median = (cfg.minSize + cfg.maxSize) / 2.0;
+        return std::max(cfg.minSize, median * std::exp(cfg.sizeSigma * z));
+    }
+    case SizeModel::PARETO:
+        // Inverse CDF with scale minSize: most levels are small, a few are huge
+        return cfg.minSize / std::pow(1.0 - uniform01(rng), 1.0 / cfg.paretoAlpha);
+    case SizeModel::UNIFORM:
+    default:
+        return cfg.minSize + (cfg.maxSize - cfg.minSize) * uniform01(rng);
+    }
+}
+
+bool isRoundPrice(const GeneratorConfig& cfg, double price) {
+    return cfg.roundEvery > 0 && std::llround(price / cfg.tickSize) % cfg.roundEvery == 0;
+}
+
+// Calls emit(price, size) for levels [first, last) of one side; level 0 is one tick
+// from mid (bids below, asks above). Gapped levels are skipped, round prices get
+// clustered liquidity.
+template <typename Emit>
+void generateLevels(const GeneratorConfig& cfg, double mid, bool isBid, int first, int last,
+                    uint64_t chunkId, Emit&& emit) {
+    double step = isBid ? -cfg.tickSize : cfg.tickSize;
+    withChunkRng(cfg, chunkId, [&](auto& rng) {
+        for (int i = first; i < last; i++) {
+            double size  = sampleSize(cfg, rng);
+            bool   gap   = cfg.gapProb > 0.0 && uniform01(rng) < cfg.gapProb;
+            // The best level on each side is never gapped, so the spread stays two ticks
+            if (gap && i > 0) continue;
+
+            double price = mid + (i + 1) * step;
+            if (isRoundPrice(cfg, price)) size *= cfg.roundBoost;
+            emit(price, size);
+        }
+    });
+}
+
+// Appends "<prefix><price>,<size>\n" with two decimals, like std::fixed << setprecision(2)
+char* formatRow(char* out, std::string_view prefix, double price, double size) {
+    out = std::copy(prefix.begin(), prefix.end(), out);
+    out = std::to_chars(out, out + 32, price, std::chars_format::fixed, 2).ptr;
+    *out++ = ',';
+    out = std::to_chars(out, out + 32, size,  std::chars_format::fixed, 2).ptr;
+    *out++ = '\n';
+    return out;
+}
+
+unsigned resolveThreads(unsigned threads) {
+    return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Formats chunks [0, chunkCount) on `threads` workers and writes them to `file` in
+// order. Work proceeds in rounds of one chunk per thread, which bounds memory to
+// `threads` chunk buffers however large the output is.
+void writeChunks(std::ofstream& file, size_t chunkCount, unsigned threads,
+                 const std::function<void(size_t chunk, std::string& buffer)>& format) {
+    std::vector<std::string> buffers(threads);
+    for (size_t base = 0; base < chunkCount; base += threads) {
+        size_t round = std::min<size_t>(threads, chunkCount - base);
+        std::vector<std::thread> workers;
+        for (size_t k = 1; k < round; k++)
+            workers.emplace_back(format, base + k, std::ref(buffers[k]));
+        format(base, buffers[0]);
+        for (auto& worker : workers) worker.join();
+
+        for (size_t k = 0; k < round; k++)
+            file.write(buffers[k].data(), static_cast<std::streamsize>(buffers[k].size()));
+    }
+    if (!file)
+        throw std::runtime_error("Failed writing output file.");
+}
+
+size_t chunksFor(long long rows) {
+    return static_cast<size_t>((rows + ROWS_PER_CHUNK - 1) / ROWS_PER_CHUNK);
+}
+
+// One book snapshot: bid chunks then ask chunks. `prefix` is prepended to the side
+// name (the timestamp column in multi-snapshot streams).
+void writeSnapshotRows(std::ofstream& file, const GeneratorConfig& cfg, double mid,
+                       const std::string& prefix, uint64_t& chunkIdBase) {
+    size_t   sideChunks = chunksFor(cfg.levels);
+    uint64_t idBase     = chunkIdBase;
+    const std::string bidPrefix = prefix + "bid,";
+    const std::string askPrefix = prefix + "ask,";
+
+    writeChunks(file, 2 * sideChunks, resolveThreads(cfg.threads), [&](size_t chunk, std::string& buffer) {
+        bool isBid = chunk < sideChunks;
+        int  first = static_cast<int>((chunk % sideChunks) * ROWS_PER_CHUNK);
+        int  last  = std::min(cfg.levels, first + ROWS_PER_CHUNK);
+        const std::string& rowPrefix = isBid ? bidPrefix : askPrefix;
+
+        buffer.resize(size_t(last - first) * (MAX_ROW_CHARS + rowPrefix.size()));
+        char* out = buffer.data();
+        generateLevels(cfg, mid, isBid, first, last, idBase + chunk, [&](double price, double size) {
+            out = formatRow(out, rowPrefix, price, size);
+        });
+        buffer.resize(size_t(out - buffer.data()));
+    });
+    chunkIdBase += 2 * sideChunks;
+}
+
+GeneratedBook generateBook(const GeneratorConfig& cfg) {
+    GeneratedBook book;
+    book.bids.reserve(cfg.levels);
+    book.asks.reserve(cfg.levels);
+
+    size_t sideChunks = chunksFor(cfg.levels);
+    for (size_t chunk = 0; chunk < 2 * sideChunks; chunk++) {
+        bool isBid = chunk < sideChunks;
+        int  first = static_cast<int>((chunk % sideChunks) * ROWS_PER_CHUNK);
+        int  last  = std::min(cfg.levels, first + ROWS_PER_CHUNK);
+        auto& side = isBid ? book.bids : book.asks;
+        generateLevels(cfg, cfg.midPrice, isBid, first, last, chunk, [&](double price, double size) {
+            side.push_back({price, size});
+        });
+    }
+    return book;
+}
+
+} // namespace
+
+void generateCSV(const GeneratorConfig& cfg) {
+    std::ofstream file(cfg.filename, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Cannot open file for writing: '" + cfg.filename + "'");
+
+    uint64_t chunkId = 0;
+    if (cfg.snapshots <= 1) {
+        file << "side,price,size\n";
+        writeSnapshotRows(file, cfg, cfg.midPrice, "", chunkId);
+        return;
+    }
+
+    // Multi-snapshot stream: the mid follows a random walk of whole ticks between snapshots
+    Xoshiro256 walk(chunkSeed(cfg, ~0ull));
+    double mid = cfg.midPrice;
+
+    file << "timestamp,side,price,size\n";
+    for (int s = 0; s < cfg.snapshots; s++) {
+        writeSnapshotRows(file, cfg, mid, std::to_string(s + 1) + ",", chunkId);
+        int step = static_cast<int>(walk() % 5) - 2;
+        mid = std::max(mid + step * cfg.tickSize, (cfg.levels + 1) * cfg.tickSize);
+    }
+}
+
+// L2 updates against the generated snapshot: level offsets skew towards the touch,
+// and one update in five removes a level. Bids stay below and asks above the original
+// mid, so applying the stream can never cross the book.
+void generateDeltas(const GeneratorConfig& cfg) {
+    std::ofstream file(cfg.deltasFile, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Cannot open file for writing: '" + cfg.deltasFile + "'");
+
+    const uint64_t DELTA_CHUNK_BASE = 1ull << 40; // disjoint from snapshot chunk ids
+    file << "side,price,size\n";
+    writeChunks(file, chunksFor(cfg.deltas), resolveThreads(cfg.threads), [&](size_t chunk, std::string& buffer) {
+        long long first = static_cast<long long>(chunk) * ROWS_PER_CHUNK;
+        long long last  = std::min(cfg.deltas, first + ROWS_PER_CHUNK);
+
+        // Level offsets are geometric with mean ~levels/8, i.e. concentrated near the touch
+        double levelDecay = std::log1p(-std::min(0.5, 8.0 / cfg.levels));
+
+        buffer.resize(size_t(last - first) * MAX_ROW_CHARS);
+        char* out = buffer.data();
+        withChunkRng(cfg, DELTA_CHUNK_BASE + chunk, [&](auto& rng) {
+            for (long long i = first; i < last; i++) {
+                bool   isBid  = uniform01(rng) < 0.5;
+                int    level  = static_cast<int>(std::min<double>(
+                                    std::floor(std::log1p(-uniform01(rng)) / levelDecay), cfg.levels - 1));
+                bool   remove = uniform01(rng) < 0.2;
+                double price  = cfg.midPrice + (level + 1) * (isBid ? -cfg.tickSize : cfg.tickSize);
+                double size   = sampleSize(cfg, rng);
+                if (isRoundPrice(cfg, price)) size *= cfg.roundBoost;
+                out = formatRow(out, isBid ? "bid," : "ask,", price, remove ? 0.0 : size);
+            }
+        });
+        buffer.resize(size_t(out - buffer.data()));
+    });
+}
+
+// Levels are generated best-first, which is exactly the order the binary format requires
+void generateBinary(const GeneratorConfig& cfg) {
+    GeneratedBook book = generateBook(cfg);
+    writeSnapshot(cfg.filename, book.bids, book.asks);
+}
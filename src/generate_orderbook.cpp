@@ -1,62 +1,87 @@
+// Synthetic order book generator: thin CLI over generateCSV / generateBinary / generateDeltas
+
+#include "orderbook/generate.h"
+
 #include <iostream>
-#include <fstream>
-#include <random>
-#include <iomanip>
-#include <string>
 #include <stdexcept>
+#include <string>
 
-struct Config {
-    std::string filename   = "orderbook.csv";
-    int         levels     = 10;      // number of price levels per side
-    double      midPrice   = 100.0;   // starting mid price
-    double      tickSize   = 0.10;    // price step between levels
-    double      maxSize    = 50.0;    // max order size
-    double      minSize    = 1.0;     // min order size
-};
-
-void generateCSV(const Config& cfg) {
-    std::ofstream file(cfg.filename);
-    if (!file.is_open())
-        throw std::runtime_error("Cannot open file for writing: '" + cfg.filename + "'");
+namespace {
 
-    // Random number generator seeded from hardware entropy
-    std::random_device rd;
-    std::mt19937 rng(rd());
-    std::uniform_real_distribution<double> sizeDist(cfg.minSize, cfg.maxSize);
+bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
 
-    file << std::fixed << std::setprecision(2);
-    file << "side,price,size\n";
+SizeModel parseSizeModel(const std::string& name) {
+    if (name == "uniform")   return SizeModel::UNIFORM;
+    if (name == "lognormal") return SizeModel::LOGNORMAL;
+    if (name == "pareto")    return SizeModel::PARETO;
+    throw std::invalid_argument("Unknown size model: '" + name + "'");
+}
 
-    // Bids: from best bid downward
-    // Best bid is one tick below mid price
-    for (int i = 1; i <= cfg.levels; i++) {
-        double price = cfg.midPrice - i * cfg.tickSize;
-        double size  = sizeDist(rng);
-        file << "bid," << price << "," << size << "\n";
-    }
+RngKind parseRngKind(const std::string& name) {
+    if (name == "mt")      return RngKind::MT19937;
+    if (name == "xoshiro") return RngKind::XOSHIRO;
+    throw std::invalid_argument("Unknown RNG: '" + name + "'");
+}
 
-    // Asks: from best ask upward
-    // Best ask is one tick above mid price
-    for (int i = 1; i <= cfg.levels; i++) {
-        double price = cfg.midPrice + i * cfg.tickSize;
-        double size  = sizeDist(rng);
-        file << "ask," << price << "," << size << "\n";
+// Positional: [filename] [levels] [mid price]; flags may appear anywhere
+GeneratorConfig parseConfig(int argc, char* argv[]) {
+    GeneratorConfig cfg;
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg + ".");
+            return argv[++i];
+        };
+        if      (arg == "--threads")   cfg.threads   = std::stoul(value());
+        else if (arg == "--snapshots") cfg.snapshots = std::stoi(value());
+        else if (arg == "--deltas")    { cfg.deltas = std::stoll(value()); cfg.deltasFile = value(); }
+        else if (arg == "--seed")      cfg.seed        = std::stoull(value());
+        else if (arg == "--rng")       cfg.rng         = parseRngKind(value());
+        else if (arg == "--sizes")     cfg.sizeModel   = parseSizeModel(value());
+        else if (arg == "--sigma")     cfg.sizeSigma   = std::stod(value());
+        else if (arg == "--alpha")     cfg.paretoAlpha = std::stod(value());
+        else if (arg == "--gaps")      cfg.gapProb     = std::stod(value());
+        else if (arg == "--round")     cfg.roundEvery  = std::stoi(value());
+        else if (arg == "--round-boost") cfg.roundBoost = std::stod(value());
+        else if (positional == 0)      { cfg.filename = arg;             positional++; }
+        else if (positional == 1)      { cfg.levels   = std::stoi(arg);  positional++; }
+        else if (positional == 2)      { cfg.midPrice = std::stod(arg);  positional++; }
+        else throw std::invalid_argument("Unexpected argument: '" + arg + "'");
     }
-
-    std::cout << "Generated " << cfg.filename
-              << " (" << cfg.levels << " bids + " << cfg.levels << " asks"
-              << ", mid = " << cfg.midPrice << ")\n";
+    if (cfg.levels <= 0)
+        throw std::invalid_argument("Levels must be > 0.");
+    if (cfg.gapProb < 0.0 || cfg.gapProb >= 1.0)
+        throw std::invalid_argument("Gap probability must be in [0, 1).");
+    if (cfg.paretoAlpha <= 0.0 || cfg.sizeSigma < 0.0 || cfg.roundBoost <= 0.0)
+        throw std::invalid_argument("Size model parameters must be positive.");
+    if (cfg.snapshots > 1 && endsWith(cfg.filename, ".obk"))
+        throw std::invalid_argument("Multi-snapshot output is only available as CSV.");
+    if (cfg.midPrice - cfg.levels * cfg.tickSize <= 0.0)
+        throw std::invalid_argument("Mid price too low: the deepest bid would not be positive.");
+    return cfg;
 }
+} // namespace
 
 int main(int argc, char* argv[]) {
-    Config cfg;
+    try {
+        GeneratorConfig cfg = parseConfig(argc, argv);
 
-    if (argc > 1) cfg.filename = argv[1];
-    if (argc > 2) cfg.levels   = std::stoi(argv[2]);
-    if (argc > 3) cfg.midPrice = std::stod(argv[3]);
+        if (endsWith(cfg.filename, ".obk")) generateBinary(cfg);
+        else                                generateCSV(cfg);
 
-    try {
-        generateCSV(cfg);
+        std::cout << "Generated " << cfg.filename
+                  << " (" << cfg.levels << " bids + " << cfg.levels << " asks"
+                  << ", mid = " << cfg.midPrice;
+        if (cfg.snapshots > 1) std::cout << ", " << cfg.snapshots << " snapshots";
+        std::cout << ")\n";
+
+        if (cfg.deltas > 0) {
+            generateDeltas(cfg);
+            std::cout << "Generated " << cfg.deltasFile << " (" << cfg.deltas << " updates)\n";
+        }
     }
     catch (const std::exception& e) {
         std::cerr << "\n[ERROR] " << e.what() << "\n\n";
@@ -64,4 +89,4 @@ int main(int argc, char* argv[]) {
     }
 
     return 0;
-}
\ No newline at end of file
+}
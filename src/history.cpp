@@ -0,0 +1,338 @@
+#include "orderbook/history.h"
+
+#include "orderbook/fixed.h"
+#include "orderbook/output.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t STATS_BYTES = 9 * sizeof(double);
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t zigzag(int64_t value)    { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+int64_t  unzigzag(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+[[noreturn]] void throwCorrupt() {
+    throw std::runtime_error("Corrupt or truncated history chunk.");
+}
+
+// Bounds-checked reader over one column
+struct ByteCursor {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) throwCorrupt();
+            uint8_t byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throwCorrupt();
+    }
+
+    // Steps over n varints without decoding them
+    void skip(uint64_t n) {
+        while (n) {
+            if (p == end) throwCorrupt();
+            if (!(*p++ & 0x80)) n--;
+        }
+    }
+};
+
+// Best price as a zigzag delta from the previous snapshot's best, then the
+// non-negative tick gaps walking away from the touch
+template <Side S>
+void encodeSide(const std::vector<FixedOrder>& levels, int64_t& prevBest,
+                std::vector<uint8_t>& prices, std::vector<uint8_t>& sizes) {
+    if (levels.empty()) return;
+    putVarint(prices, zigzag(levels[0].price - prevBest));
+    prevBest = levels[0].price;
+    for (size_t i = 0; i < levels.size(); i++) {
+        if (i > 0) {
+            int64_t gap = SideTraits<S>::isBid ? levels[i - 1].price - levels[i].price
+                                               : levels[i].price - levels[i - 1].price;
+            if (gap < 0) throw std::invalid_argument("History snapshots must be sorted best-first.");
+            putVarint(prices, static_cast<uint64_t>(gap));
+        }
+        if (levels[i].size < 0) throw std::invalid_argument("History sizes must not be negative.");
+        putVarint(sizes, static_cast<uint64_t>(levels[i].size));
+    }
+}
+
+// Integer units back to price units. Dividing by an exact power-of-ten inverse
+// rounds like parsing the decimal text did (9980 / 100 == 99.8, 9980 * 0.01 is not).
+struct UnitScale {
+    double increment;
+    double inverse;  // 0 when 1 / increment is not a whole number
+
+    explicit UnitScale(double inc) : increment(inc), inverse(0.0) {
+        double inv = std::round(1.0 / inc);
+        if (inv >= 1.0 && std::abs(inv * inc - 1.0) < 1e-12) inverse = inv;
+    }
+    double operator()(int64_t units) const {
+        return inverse > 0.0 ? static_cast<double>(units) / inverse : static_cast<double>(units) * increment;
+    }
+};
+
+// Decodes the first `keep` levels of one side (all when keep >= count) and skips the rest
+template <Side S>
+void decodeSide(ByteCursor& prices, ByteCursor& sizes, uint64_t count, uint64_t keep, int64_t& prevBest,
+                const UnitScale& tick, const UnitScale& lot, std::vector<Order>& out) {
+    out.clear();
+    if (count == 0) return;
+    int64_t price = prevBest + unzigzag(prices.varint());
+    prevBest = price;
+
+    keep = std::min(keep, count);
+    for (uint64_t i = 0; i < keep; i++) {
+        if (i > 0) {
+            int64_t gap = static_cast<int64_t>(prices.varint());
+            price = SideTraits<S>::isBid ? price - gap : price + gap;
+        }
+        out.push_back(Order{S, tick(price), lot(static_cast<int64_t>(sizes.varint()))});
+    }
+    prices.skip(count - std::max<uint64_t>(keep, 1));
+    sizes.skip(count - keep);
+}
+
+} // namespace
+
+HistoryWriter::HistoryWriter(const std::string& filename, double tickSize, double lotSize, size_t chunkSnapshots)
+    : filename_(filename), file_(filename, std::ios::binary | std::ios::trunc),
+      tickSize_(tickSize), lotSize_(lotSize), chunkSnapshots_(std::max<size_t>(chunkSnapshots, 1)) {
+    if (!file_.is_open())
+        throw std::runtime_error("Cannot open file for writing: '" + filename + "'");
+    HistoryHeader header{};
+    std::memcpy(header.magic, HISTORY_MAGIC, sizeof(HISTORY_MAGIC));
+    header.version = littleEndian(HISTORY_VERSION);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    offset_ = sizeof(header);
+}
+
+HistoryWriter::~HistoryWriter() {
+    try {
+        finish();
+    } catch (const std::exception&) {
+        // destructors must not throw; call finish() explicitly to see write errors
+    }
+}
+
+void HistoryWriter::append(int64_t timestamp, const Orderbook& book, const Stats& stats) {
+    if (finished_) throw std::runtime_error("History '" + filename_ + "' is already finished.");
+    if (total_ > 0 && timestamp < prevTime_)
+        throw std::invalid_argument("Snapshot time " + std::to_string(timestamp) +
+                                    " is earlier than the previous one (" + std::to_string(prevTime_) + ").");
+
+    FixedBook fixed = toChunkGrid(book);
+
+    bool firstInChunk = chunk_.snapshots == 0;
+    putVarint(columns_[TIME], zigzag(firstInChunk ? timestamp : timestamp - prevTime_));
+    putVarint(columns_[COUNTS], fixed.bids.size());
+    putVarint(columns_[COUNTS], fixed.asks.size());
+    encodeSide<Side::BID>(fixed.bids, prevBid_, columns_[BID_PRICES], columns_[BID_SIZES]);
+    encodeSide<Side::ASK>(fixed.asks, prevAsk_, columns_[ASK_PRICES], columns_[ASK_SIZES]);
+
+    std::array<double, 9> values = statsValues(stats);
+    for (double& v : values) v = littleEndian(v);
+    auto& raw = columns_[STATS];
+    raw.resize(raw.size() + STATS_BYTES);
+    std::memcpy(raw.data() + raw.size() - STATS_BYTES, values.data(), STATS_BYTES);
+
+    if (firstInChunk) chunk_.firstTime = timestamp;
+    chunk_.lastTime = timestamp;
+    chunk_.snapshots++;
+    prevTime_ = timestamp;
+    total_++;
+    if (chunk_.snapshots == chunkSnapshots_) flushChunk();
+}
+
+// Converts `book` to the current chunk's grid. When an inferred increment is too coarse
+// for it, the chunk is closed and the next one starts on the finer of the two grids
+// (both are powers of ten, so the finer one holds every earlier value too).
+FixedBook HistoryWriter::toChunkGrid(const Orderbook& book) {
+    if (chunkTick_ > 0.0) {
+        try {
+            return toFixed(book, chunkTick_, chunkLot_);
+        } catch (const std::runtime_error&) {
+            // off the current grid: refine the inferred increments below
+        }
+    }
+
+    FixedBook fixed;
+    try {
+        fixed = toFixed(book, tickSize_, lotSize_);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(std::string(e.what()) + " Recording needs every snapshot on one grid: pass a finer"
+                                 " --tick / --lot, or leave them unset to infer them per chunk.");
+    }
+    double tick = chunkTick_ > 0.0 ? std::min(chunkTick_, fixed.tickSize) : fixed.tickSize;
+    double lot  = chunkLot_  > 0.0 ? std::min(chunkLot_,  fixed.lotSize)  : fixed.lotSize;
+    if (chunkTick_ > 0.0) {
+        flushChunk();
+        fixed = toFixed(book, tick, lot);
+    }
+    chunkTick_  = tick;
+    chunkLot_   = lot;
+    finestTick_ = finestTick_ > 0.0 ? std::min(finestTick_, tick) : tick;
+    finestLot_  = finestLot_  > 0.0 ? std::min(finestLot_,  lot)  : lot;
+    return fixed;
+}
+
+void HistoryWriter::flushChunk() {
+    if (chunk_.snapshots == 0) return;
+    HistoryChunkHeader header{};
+    header.snapshots = chunk_.snapshots;
+    uint64_t bytes   = sizeof(header);
+    for (size_t c = 0; c < HISTORY_COLUMNS; c++) {
+        header.columnBytes[c] = columns_[c].size();
+        bytes += columns_[c].size();
+    }
+    header = littleEndian(header);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (auto& column : columns_) {
+        file_.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size()));
+        column.clear();  // keeps capacity for the next chunk
+    }
+
+    chunk_.offset   = offset_;
+    chunk_.tickSize = chunkTick_;
+    chunk_.lotSize  = chunkLot_;
+    index_.push_back(chunk_);
+    offset_  += bytes;
+    chunk_    = {};
+    prevBid_  = prevAsk_ = 0;
+}
+
+void HistoryWriter::finish() {
+    if (finished_) return;
+    finished_ = true;
+    flushChunk();
+
+    HistoryTail tail{};
+    tail.indexOffset = offset_;
+    tail.chunkCount  = index_.size();
+    tail.tickSize    = finestTick_ > 0.0 ? finestTick_ : tickSize_;
+    tail.lotSize     = finestLot_  > 0.0 ? finestLot_  : lotSize_;
+    std::memcpy(tail.magic, HISTORY_TAIL, sizeof(HISTORY_TAIL));
+    tail.version = HISTORY_VERSION;
+
+    for (HistoryChunkIndex chunk : index_) {
+        chunk = littleEndian(chunk);
+        file_.write(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+    }
+    tail = littleEndian(tail);
+    file_.write(reinterpret_cast<const char*>(&tail), sizeof(tail));
+    file_.close();
+    if (!file_)
+        throw std::runtime_error("Failed writing history: '" + filename_ + "'");
+}
+
+HistoryReader::HistoryReader(const std::string& filename) : filename_(filename), file_(filename) {
+    std::string_view data = file_.view();
+    if (data.size() < sizeof(HistoryHeader) + sizeof(HistoryTail) ||
+        std::memcmp(data.data(), HISTORY_MAGIC, sizeof(HISTORY_MAGIC)) != 0)
+        throw std::runtime_error("Not a history file: '" + filename + "'");
+
+    std::memcpy(&tail_, data.data() + data.size() - sizeof(tail_), sizeof(tail_));
+    tail_ = littleEndian(tail_);
+    if (std::memcmp(tail_.magic, HISTORY_TAIL, sizeof(HISTORY_TAIL)) != 0)
+        throw std::runtime_error("Truncated history (no index): '" + filename + "'");
+    if (tail_.version != HISTORY_VERSION)
+        throw std::runtime_error("Unsupported history version " + std::to_string(tail_.version) + ".");
+
+    uint64_t indexBytes = data.size() - sizeof(tail_) - tail_.indexOffset;
+    if (tail_.indexOffset < sizeof(HistoryHeader) || tail_.indexOffset > data.size() - sizeof(tail_) ||
+        indexBytes != tail_.chunkCount * sizeof(HistoryChunkIndex))
+        throw std::runtime_error("Corrupt history index: '" + filename + "'");
+
+    index_.resize(tail_.chunkCount);
+    std::memcpy(index_.data(), data.data() + tail_.indexOffset, indexBytes);
+    for (auto& chunk : index_) {
+        chunk = littleEndian(chunk);
+        if (chunk.offset < sizeof(HistoryHeader) || chunk.offset + sizeof(HistoryChunkHeader) > tail_.indexOffset)
+            throw std::runtime_error("Corrupt history index: '" + filename + "'");
+    }
+}
+
+uint64_t HistoryReader::snapshots() const {
+    uint64_t total = 0;
+    for (const auto& chunk : index_) total += chunk.snapshots;
+    return total;
+}
+
+size_t HistoryReader::replay(const HistoryQuery& query,
+                             const std::function<void(const HistoryRecord&)>& visit) const {
+    const auto* base = reinterpret_cast<const uint8_t*>(file_.view().data());
+    bool wantBids  = query.columns & HISTORY_BIDS;
+    bool wantAsks  = query.columns & HISTORY_ASKS;
+    bool wantStats = query.columns & HISTORY_STATS;
+    uint64_t keep  = query.maxLevels ? query.maxLevels : std::numeric_limits<uint64_t>::max();
+    HistoryRecord record{};
+    size_t visited = 0;
+
+    // The index is in time order: skip every chunk that ends before the range
+    auto chunk = std::partition_point(index_.begin(), index_.end(),
+                                      [&](const HistoryChunkIndex& c) { return c.lastTime < query.from; });
+    for (; chunk != index_.end() && chunk->firstTime <= query.to; ++chunk) {
+        HistoryChunkHeader header;
+        std::memcpy(&header, base + chunk->offset, sizeof(header));
+        header = littleEndian(header);
+
+        std::array<ByteCursor, HISTORY_COLUMNS> columns;
+        const uint8_t* p     = base + chunk->offset + sizeof(header);
+        const uint8_t* limit = base + tail_.indexOffset;
+        for (size_t c = 0; c < HISTORY_COLUMNS; c++) {
+            if (header.columnBytes[c] > static_cast<uint64_t>(limit - p)) throwCorrupt();
+            columns[c] = {p, p + header.columnBytes[c]};
+            p += header.columnBytes[c];
+        }
+        if (header.snapshots != chunk->snapshots || header.columnBytes[STATS] != header.snapshots * STATS_BYTES)
+            throwCorrupt();
+
+        UnitScale tick(chunk->tickSize), lot(chunk->lotSize);
+        int64_t   time = 0, prevBid = 0, prevAsk = 0;
+        for (uint64_t i = 0; i < header.snapshots; i++) {
+            time += unzigzag(columns[TIME].varint());
+            if (time > query.to) return visited;
+            bool inRange = time >= query.from;
+
+            // Price deltas chain through the chunk, so out-of-range snapshots of a
+            // requested side are still stepped over (cheaply, without decoding)
+            if (wantBids || wantAsks) {
+                uint64_t bidCount = columns[COUNTS].varint();
+                uint64_t askCount = columns[COUNTS].varint();
+                if (wantBids)
+                    decodeSide<Side::BID>(columns[BID_PRICES], columns[BID_SIZES], bidCount, inRange ? keep : 0,
+                                          prevBid, tick, lot, record.book.bids);
+                if (wantAsks)
+                    decodeSide<Side::ASK>(columns[ASK_PRICES], columns[ASK_SIZES], askCount, inRange ? keep : 0,
+                                          prevAsk, tick, lot, record.book.asks);
+            }
+            if (!inRange) continue;
+
+            if (wantStats) {
+                std::array<double, 9> v;
+                std::memcpy(v.data(), columns[STATS].p + i * STATS_BYTES, STATS_BYTES);
+                for (double& x : v) x = littleEndian(x);
+                record.stats = {v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8]};
+            }
+            record.timestamp = time;
+            visit(record);
+            visited++;
+        }
+    }
+    return visited;
+}
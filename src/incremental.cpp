@@ -0,0 +1,56 @@
+#include "orderbook/incremental.h"
+
+#include "orderbook/load.h"
+#include "orderbook/parse.h"
+
+LevelUpdate parseUpdateRow(std::string_view line, int lineNumber) {
+    std::string_view rest     = line;
+    std::string_view sideStr  = trimView(nextField(rest));
+    std::string_view priceStr = trimView(nextField(rest));
+    std::string_view sizeStr  = trimView(nextField(rest));
+
+    if (sideStr.empty() || priceStr.empty() || sizeStr.empty())
+        throw std::invalid_argument(
+            "Line " + std::to_string(lineNumber) + " has empty fields."
+        );
+
+    LevelUpdate update;
+    update.side  = parseSide  (sideStr);
+    update.price = parseDouble(priceStr, "price");
+    update.size  = parseDouble(sizeStr,  "size", true);
+    return update;
+}
+
+bool tryParseUpdateRow(std::string_view line, LevelUpdate& update) noexcept {
+    std::string_view rest     = line;
+    std::string_view sideStr  = trimView(nextField(rest));
+    std::string_view priceStr = trimView(nextField(rest));
+    std::string_view sizeStr  = trimView(nextField(rest));
+
+    return tryParseSide  (sideStr,  update.side) &&
+           tryParseDouble(priceStr, update.price) &&
+           tryParseDouble(sizeStr,  update.size, true);
+}
+
+size_t applyUpdatesCSV(IncrementalBook& book, const std::string& filename) {
+    MappedFile       file(filename);
+    std::string_view data = file.view();
+
+    size_t applied    = 0;
+    int    lineNumber = 0;
+    size_t pos        = 0;
+    while (pos < data.size()) {
+        size_t eol = data.find('\n', pos);
+        if (eol == std::string_view::npos) eol = data.size();
+        std::string_view line = data.substr(pos, eol - pos);
+        pos = eol + 1;
+
+        lineNumber++;
+        if (lineNumber == 1) continue; // skip header
+        if (trimView(line).empty()) continue;
+
+        book.apply(parseUpdateRow(line, lineNumber));
+        applied++;
+    }
+    return applied;
+}
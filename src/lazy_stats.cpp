@@ -0,0 +1,34 @@
+#include "orderbook/lazy_stats.h"
+
+#include "orderbook/output.h"
+#include "orderbook/parse.h"
+
+#include <string_view>
+#include <algorithm>
+#include <stdexcept>
+
+std::vector<std::string> parseMetricList(const std::string& list) {
+    std::vector<std::string> metrics;
+    std::string_view rest = list;
+    while (!rest.empty()) {
+        std::string name(trimView(nextField(rest)));
+        const auto& known = metricNames();
+        if (std::find(known.begin(), known.end(), name) == known.end())
+            throw std::invalid_argument("Unknown metric: '" + name + "'");
+        metrics.push_back(name);
+    }
+    return metrics;
+}
+
+std::optional<double> readMetric(const LazyStats& stats, const std::string& name) {
+    if (name == "best_bid")   return stats.bestBid();
+    if (name == "best_ask")   return stats.bestAsk();
+    if (name == "mid")        return stats.midPrice();
+    if (name == "spread")     return stats.spread();
+    if (name == "spread_pct") return stats.spreadPct();
+    if (name == "bid_depth")  return stats.bidDepth();
+    if (name == "ask_depth")  return stats.askDepth();
+    if (name == "vwap_buy")   return stats.vwapBuy();
+    if (name == "vwap_sell")  return stats.vwapSell();
+    throw std::invalid_argument("Unknown metric: '" + name + "'");
+}
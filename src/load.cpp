@@ -0,0 +1,297 @@
+#include "orderbook/load.h"
+
+#include "orderbook/parse.h"
+#include "orderbook/profile.h"
+#include "orderbook/snapshot_format.h"
+
+#include <fstream>
+#include <thread>
+#include <functional>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <exception>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void loadCSV(const std::string& filename, const BookShape& shape, Orderbook& book) {
+    std::ifstream file(filename);
+    if (!file.is_open())
+        throw std::runtime_error("Cannot open file: '" + filename + "'");
+
+    book.bids.clear();
+    book.asks.clear();
+    std::string line;
+    int lineNumber = 0;
+
+    std::getline(file, line); // skip header
+    lineNumber++;
+
+    for (;;) {
+        {
+            ProfileScope scope(Stage::READ);
+            if (!std::getline(file, line)) break;
+        }
+        lineNumber++;
+        if (trimView(line).empty()) continue;
+
+        ProfileScope scope(Stage::PARSE);
+        Order order = parseRow(line, lineNumber);
+        if (order.side == Side::BID) book.bids.push_back(order);
+        else                         book.asks.push_back(order);
+    }
+
+    finalizeBook(book, shape);
+}
+
+Orderbook loadCSV(const std::string& filename, const BookShape& shape) {
+    Orderbook book;
+    loadCSV(filename, shape, book);
+    return book;
+}
+
+MappedFile::MappedFile(const std::string& filename) {
+    ProfileScope scope(Stage::READ);
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open file: '" + filename + "'");
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot open file: '" + filename + "'");
+    }
+
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map file: '" + filename + "'");
+        }
+        ::madvise(addr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(addr);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+}
+
+namespace {
+
+// The error parseRow raises for `line` once it is numbered within the whole file. Rows
+// are numbered within their chunk while the workers run; only a failing row pays for
+// counting the lines in `before`, the text ahead of its chunk (header included).
+// Called from a handler, so the error being handled is kept if the row now parses.
+std::exception_ptr numberedRowError(std::string_view before, std::string_view line, int lineInChunk) {
+    int lineNumber = lineInChunk + static_cast<int>(std::count(before.begin(), before.end(), '\n'));
+    try {
+        parseRow(line, lineNumber);
+    } catch (const std::invalid_argument&) {
+        return std::current_exception();
+    } catch (const std::runtime_error&) {
+        return std::current_exception();
+    }
+    return std::current_exception();
+}
+
+// Parses every line of `chunk`, stopping at the first bad row with its error in
+// out.error. Only parse errors are caught per row; anything else (bad_alloc) also
+// lands in out.error, since it cannot leave a worker thread, and is rethrown unchanged.
+void parseChunk(std::string_view before, std::string_view chunk, ChunkResult& out) {
+    ProfileScope scope(Stage::PARSE);  // per chunk: line splitting and parseRow together
+    out.bids.clear();
+    out.asks.clear();
+    out.lines = 0;
+    out.error = nullptr;
+
+    try {
+        size_t pos = 0;
+        while (pos < chunk.size()) {
+            size_t eol = chunk.find('\n', pos);
+            if (eol == std::string_view::npos) eol = chunk.size();
+            std::string_view line = chunk.substr(pos, eol - pos);
+            pos = eol + 1;
+
+            out.lines++;
+            if (trimView(line).empty()) continue;
+
+            Order order;
+            try {
+                order = parseRow(line, out.lines);
+            } catch (const std::invalid_argument&) {
+                out.error = numberedRowError(before, line, out.lines);
+                return;
+            } catch (const std::runtime_error&) {
+                out.error = numberedRowError(before, line, out.lines);
+                return;
+            }
+            if (order.side == Side::BID) out.bids.push_back(order);
+            else                         out.asks.push_back(order);
+        }
+    } catch (...) {
+        out.error = std::current_exception();
+    }
+}
+
+// Rethrows the first failure in file order, as the worker raised it
+void rethrowFirstChunkError(const std::vector<ChunkResult>& chunks) {
+    for (const auto& chunk : chunks)
+        if (chunk.error) std::rethrow_exception(chunk.error);
+}
+
+// Splits the body into `count` ranges, each ending just past a '\n' (or at EOF)
+std::vector<std::string_view> splitChunks(std::string_view body, size_t count) {
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    for (size_t k = 1; k <= count && begin < body.size(); k++) {
+        size_t end = (k == count) ? body.size() : std::max(begin, body.size() * k / count);
+        if (end < body.size()) {
+            size_t eol = body.find('\n', end);
+            end = (eol == std::string_view::npos) ? body.size() : eol + 1;
+        }
+        chunks.push_back(body.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+} // namespace
+
+void parseCSV(std::string_view data, unsigned threads, const BookShape& shape,
+              Orderbook& book, LoadBuffers& buffers) {
+    const size_t MIN_CHUNK_BYTES = 1 << 20; // below this, thread startup costs more than it saves
+
+    size_t headerEnd = data.find('\n');
+    std::string_view body = (headerEnd == std::string_view::npos) ? std::string_view{}
+                                                                  : data.substr(headerEnd + 1);
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t count = std::clamp<size_t>(body.size() / MIN_CHUNK_BYTES, 1, threads);
+
+    std::vector<std::string_view> ranges = splitChunks(body, count);
+    std::vector<ChunkResult>&     chunks = buffers.chunks;
+    if (ranges.empty()) ranges.push_back({}); // empty body still yields one (empty) chunk
+    chunks.resize(ranges.size());             // shrinking keeps the surviving buffers
+    std::vector<std::thread>      workers;
+    auto before = [&](size_t k) {  // text ahead of chunk k, for numbering its failing row
+        return ranges[k].data() ? data.substr(0, size_t(ranges[k].data() - data.data())) : data;
+    };
+    for (size_t k = 1; k < ranges.size(); k++)
+        workers.emplace_back(parseChunk, before(k), ranges[k], std::ref(chunks[k]));
+    parseChunk(before(0), ranges[0], chunks[0]);
+    for (auto& worker : workers) worker.join();
+
+    rethrowFirstChunkError(chunks);
+
+    if (chunks.size() == 1) {
+        // Single chunk: trade buffers instead of copying; both sides keep their capacity
+        std::swap(book.bids, chunks[0].bids);
+        std::swap(book.asks, chunks[0].asks);
+    } else {
+        size_t bidCount = 0, askCount = 0;
+        for (const auto& chunk : chunks) {
+            bidCount += chunk.bids.size();
+            askCount += chunk.asks.size();
+        }
+        book.bids.clear();
+        book.asks.clear();
+        book.bids.reserve(bidCount);
+        book.asks.reserve(askCount);
+        for (const auto& chunk : chunks) {
+            book.bids.insert(book.bids.end(), chunk.bids.begin(), chunk.bids.end());
+            book.asks.insert(book.asks.end(), chunk.asks.begin(), chunk.asks.end());
+        }
+    }
+
+    finalizeBook(book, shape);
+}
+
+void loadCSVParallel(const std::string& filename, unsigned threads, const BookShape& shape,
+                     Orderbook& book, LoadBuffers& buffers) {
+    MappedFile file(filename);
+    parseCSV(file.view(), threads, shape, book, buffers);
+}
+
+Orderbook loadCSVParallel(const std::string& filename, unsigned threads, const BookShape& shape) {
+    Orderbook   book;
+    LoadBuffers buffers;
+    loadCSVParallel(filename, threads, shape, book, buffers);
+    return book;
+}
+
+Orderbook loadCSVMapped(const std::string& filename) {
+    return loadCSVParallel(filename, 1);
+}
+
+bool isBinarySnapshot(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(SNAPSHOT_MAGIC)] = {};
+    file.read(magic, sizeof(magic));
+    return file && hasSnapshotMagic(magic, sizeof(magic));
+}
+
+bool isBinarySnapshotData(std::string_view data) {
+    return hasSnapshotMagic(data.data(), data.size());
+}
+
+void parseBinary(std::string_view data, const std::string& filename, const BookShape& shape, Orderbook& book) {
+    SnapshotHeader header;
+    if (data.size() < sizeof(header) || !hasSnapshotMagic(data.data(), data.size()))
+        throw std::runtime_error("Not a binary snapshot: '" + filename + "'");
+    std::memcpy(&header, data.data(), sizeof(header));
+    header = littleEndian(header);
+    if (header.version != SNAPSHOT_VERSION)
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(header.version) + ".");
+    uint64_t maxLevels = (data.size() - sizeof(header)) / sizeof(SnapshotLevel);
+    if (header.bidCount > maxLevels || header.askCount > maxLevels - header.bidCount ||
+        data.size() != sizeof(header) + (header.bidCount + header.askCount) * sizeof(SnapshotLevel))
+        throw std::runtime_error("Truncated snapshot: '" + filename + "'");
+
+    auto copySide = [](const char* src, uint64_t count, Side side, std::vector<Order>& out) {
+        out.resize(count);
+        for (uint64_t i = 0; i < count; i++) {
+            SnapshotLevel level;
+            std::memcpy(&level, src + i * sizeof(level), sizeof(level));
+            level  = littleEndian(level);
+            out[i] = Order{side, level.price, level.size};
+        }
+    };
+
+    const char* levels = data.data() + sizeof(header);
+    {
+        ProfileScope scope(Stage::READ);  // first touch of the mapped pages
+        copySide(levels, header.bidCount, Side::BID, book.bids);
+        copySide(levels + header.bidCount * sizeof(SnapshotLevel), header.askCount, Side::ASK, book.asks);
+    }
+
+    ProfileScope scope(Stage::SORT);
+    shapeBook(book, shape);
+    validateBook(book);
+}
+
+void loadBinary(const std::string& filename, const BookShape& shape, Orderbook& book) {
+    MappedFile file(filename);
+    parseBinary(file.view(), filename, shape, book);
+}
+
+Orderbook loadBinary(const std::string& filename, const BookShape& shape) {
+    Orderbook book;
+    loadBinary(filename, shape, book);
+    return book;
+}
+
+void saveBinary(const Orderbook& book, const std::string& filename) {
+    auto toLevels = [](const std::vector<Order>& orders) {
+        std::vector<SnapshotLevel> levels;
+        levels.reserve(orders.size());
+        for (const auto& order : orders) levels.push_back({order.price, order.size});
+        return levels;
+    };
+    writeSnapshot(filename, toLevels(book.bids), toLevels(book.asks));
+}
@@ -1,228 +1,730 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
 #include <iomanip>
-#include <cmath>
-
-enum class Side { BID, ASK };
-
-struct Order {
-    Side   side;
-    double price;
-    double size;
-};
-
-// Invariant: after loadCSV, bids are sorted descending and asks ascending,
-// so [0] is always the best price on each side.
-struct Orderbook {
-    std::vector<Order> bids;
-    std::vector<Order> asks;
-};
-
-struct Stats {
-    double bestBid;
-    double bestAsk;
-    double midPrice;
-    double spread;
-    double spreadPct;
-    double bidDepth;
-    double askDepth;
-    double vwapBuy;
-    double vwapSell;
+#include <optional>
+#include <array>
+#include <thread>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <filesystem>
+#include <csignal>
+#include <cstdio>
+#include <limits>
+
+#include "orderbook/calc.h"
+#include "orderbook/consolidated.h"
+#include "orderbook/cost.h"
+#include "orderbook/feed.h"
+#include "orderbook/fixed.h"
+#include "orderbook/history.h"
+#include "orderbook/incremental.h"
+#include "orderbook/lazy_stats.h"
+#include "orderbook/load.h"
+#include "orderbook/output.h"
+#include "orderbook/parse.h"
+#include "orderbook/prefetch.h"
+#include "orderbook/profile.h"
+#include "orderbook/server.h"
+#include "orderbook/simd.h"
+#include "orderbook/stream.h"
+
+// Command-line options; anything that is not a flag is the input file
+struct Options {
+    std::string filename  = "orderbook.csv";
+    bool        useMmap   = false;
+    unsigned    threads   = 1;        // parser threads for the mmap loader, 0 = all cores
+    std::string convertTo;            // when set, write the loaded book as a binary snapshot
+    std::string kernels   = "auto";
+    std::vector<double> depthCurvePcts;  // optional liquidity curve percentages
+    std::vector<double> impactQtys;      // optional impact curve sizes, sorted on parse
+    std::string deltasFile;           // L2 updates applied on top of the snapshot
+    bool        stream    = false;    // multi-snapshot input, one stats row per snapshot
+    std::string batchPath;            // directory or manifest of files to analyze
+    unsigned    jobs      = 0;        // batch worker threads, 0 = all cores
+    bool        fixed     = false;    // integer ticks/lots arithmetic
+    double      tickSize  = 0.0;      // fixed-point price increment, 0 = infer
+    double      lotSize   = 0.0;      // fixed-point size increment, 0 = infer
+    bool        unordered = false;    // batch rows in completion order
+    size_t      prefetch  = 0;        // batch read-ahead buffers, 0 = workers read their own files
+    bool        help      = false;
+    BookShape   shape;                // level aggregation applied on load
+    std::vector<std::string> metrics; // when set, print only these (computed lazily)
+    std::optional<OutputFormat> format;  // machine-readable output instead of the table
+    bool        filenameSet = false;  // an input file was named explicitly
+    int         feedPort    = -1;     // UDP port for live updates, -1 = off
+    double      feedSeconds = 0.0;    // feed run time, 0 = until interrupted
+    double      feedEveryMs = 1000.0; // feed stats print interval
+    std::string venuesPath;           // directory or manifest of per-venue books to consolidate
+    double      rollingWindow = 0.0;  // stream rolling-metrics window in timestamp units, 0 = off
+    std::string recordPath;           // stream mode also appends every snapshot to this history file
+    std::string replayPath;           // history file to replay instead of reading text
+    int64_t     replayFrom = std::numeric_limits<int64_t>::min();
+    int64_t     replayTo   = std::numeric_limits<int64_t>::max();
+    bool        profile    = false;   // per-stage timing summary on stderr at exit
+    std::vector<double> slippageBps;  // optional max-size-within-slippage limits
+    std::vector<double> movePrices;   // optional cost-to-move-the-touch targets
+    std::string servePath;            // Unix socket to answer queries on, books kept resident
+    std::string queryPath;            // Unix socket of a running server to send stdin lines to
 };
 
-std::string trim(const std::string& s) {
-    const std::string ws = " \t\r\n";
-    size_t start = s.find_first_not_of(ws);
-    if (start == std::string::npos) return "";
-    size_t end = s.find_last_not_of(ws);
-    return s.substr(start, end - start + 1);
+Options parseOptions(int argc, const char* argv[]) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg + ".");
+            return argv[++i];
+        };
+        if      (arg == "--help" || arg == "-h") opt.help = true;
+        else if (arg == "--mmap")        opt.useMmap = true;
+        else if (arg == "--threads")     { opt.useMmap = true; opt.threads = std::stoul(value()); }
+        else if (arg == "--convert")     opt.convertTo = value();
+        else if (arg == "--kernels")     opt.kernels   = value();
+        else if (arg == "--depth-curve") opt.depthCurvePcts = parseDoubleList(value(), "depth-curve");
+        else if (arg == "--deltas")      opt.deltasFile = value();
+        else if (arg == "--stream")      opt.stream     = true;
+        else if (arg == "--batch")       opt.batchPath  = value();
+        else if (arg == "--jobs")        opt.jobs       = std::stoul(value());
+        else if (arg == "--unordered")   opt.unordered  = true;
+        else if (arg == "--prefetch")    opt.prefetch   = std::stoul(value());
+        else if (arg == "--aggregate")   opt.shape.aggregate = true;
+        else if (arg == "--bucket")      opt.shape.bucket    = parseDouble(value(), "bucket");
+        else if (arg == "--top")         opt.shape.topLevels = std::stoul(value());
+        else if (arg == "--band")        opt.shape.bandPct   = parseDouble(value(), "band");
+        else if (arg == "--metrics")     opt.metrics = parseMetricList(value());
+        else if (arg == "--format")      opt.format  = parseOutputFormat(value());
+        else if (arg == "--fixed")       opt.fixed      = true;
+        else if (arg == "--tick")        { opt.fixed = true; opt.tickSize = parseDouble(value(), "tick"); }
+        else if (arg == "--lot")         { opt.fixed = true; opt.lotSize  = parseDouble(value(), "lot"); }
+        else if (arg == "--impact") {
+            opt.impactQtys = parseDoubleList(value(), "impact");
+            std::sort(opt.impactQtys.begin(), opt.impactQtys.end());
+        }
+        else if (arg == "--feed")        opt.feedPort    = std::stoi(value());
+        else if (arg == "--feed-seconds") opt.feedSeconds = parseDouble(value(), "feed-seconds");
+        else if (arg == "--feed-every")  opt.feedEveryMs = parseDouble(value(), "feed-every");
+        else if (arg == "--venues")      opt.venuesPath  = value();
+        else if (arg == "--rolling")     { opt.stream = true; opt.rollingWindow = parseDouble(value(), "rolling"); }
+        else if (arg == "--record")      { opt.stream = true; opt.recordPath = value(); }
+        else if (arg == "--replay")      opt.replayPath = value();
+        else if (arg == "--profile")     opt.profile    = true;
+        else if (arg == "--max-slippage") opt.slippageBps = parseDoubleList(value(), "max-slippage");
+        else if (arg == "--move-to")     opt.movePrices  = parseDoubleList(value(), "move-to");
+        else if (arg == "--serve")       opt.servePath  = value();
+        else if (arg == "--query")       opt.queryPath  = value();
+        else if (arg == "--from")        opt.replayFrom = std::stoll(value());
+        else if (arg == "--to")          opt.replayTo   = std::stoll(value());
+        else                             { opt.filename = arg; opt.filenameSet = true; }
+    }
+    if (opt.prefetch > 0 && opt.useMmap)
+        throw std::invalid_argument("--prefetch parses from its own read buffers; it cannot be combined "
+                                    "with --mmap or --threads.");
+    return opt;
 }
 
-Side parseSide(const std::string& raw) {
-    std::string s = raw;
-    for (char& c : s) c = static_cast<char>(::tolower(c));
-    if (s == "bid") return Side::BID;
-    if (s == "ask") return Side::ASK;
-    throw std::invalid_argument("Unknown order side: '" + raw + "'");
+const char* USAGE = R"(Usage: orderbook [FILE] [options]
+
+Input (FILE defaults to orderbook.csv; .obk files are binary snapshots):
+  --mmap                  memory-mapped loader
+  --threads N             parse on N threads (0 = all cores), implies --mmap
+  --aggregate             merge levels that share a price
+  --bucket X              snap prices to tick X, then merge
+  --top N                 keep the best N levels per side
+  --band PCT              keep levels within PCT% of mid
+  --kernels NAME          avx512 | avx2 | neon | scalar | auto
+
+Single book:
+  --depth-curve LIST      depth at every percentage in LIST
+  --impact LIST           VWAP and slippage for every size in LIST
+  --max-slippage LIST     largest size within each bps limit of mid
+  --move-to LIST          cost of moving the touch to each price
+  --metrics LIST          print only these metrics
+  --fixed, --tick X, --lot X   integer tick / lot arithmetic
+  --deltas FILE           apply L2 updates on top of the snapshot
+  --convert OUT.obk       write the loaded book as a binary snapshot
+  --format FMT            csv | tsv | jsonl | binary record instead of the table
+
+Many snapshots or files:
+  --stream                one stats row per snapshot of a multi-snapshot file (- = stdin)
+  --rolling W             rolling metrics over a window of W timestamp units (implies --stream)
+  --record FILE           also append every streamed snapshot to a history file
+  --replay FILE           replay a history file; --from T / --to T bound it
+  --batch PATH            analyze every file of a directory or manifest
+  --jobs N                batch worker threads (default all cores)
+  --unordered             batch rows in completion order
+  --prefetch N            batch read-ahead into N buffers on reader threads (default 0 = off;
+                          each worker then loads its own file). Cannot be combined with
+                          --mmap/--threads, since prefetched files are parsed from memory.
+  --venues PATH           consolidate one book per venue file
+
+Live and resident:
+  --feed PORT             UDP level updates; --feed-seconds N, --feed-every MS
+  --serve SOCKET          keep books resident and answer queries on a Unix socket
+  --query SOCKET          send stdin lines to a running server
+
+  --profile               per-stage timing summary on stderr
+  --help                  this text
+)";
+
+void loadBook(const Options& opt, Orderbook& book, LoadBuffers& buffers) {
+    if      (isBinarySnapshot(opt.filename)) loadBinary(opt.filename, opt.shape, book);
+    else if (opt.useMmap)                    loadCSVParallel(opt.filename, opt.threads, opt.shape, book, buffers);
+    else                                     loadCSV(opt.filename, opt.shape, book);
 }
 
-double parseDouble(const std::string& raw, const std::string& fieldName) {
-    try {
-        double value = std::stod(raw);
-        if (!std::isfinite(value) || value <= 0.0)
-            throw std::invalid_argument("Value must be finite and > 0.");
-        return value;
-    } catch (const std::exception&) {
-        throw std::invalid_argument(
-            "Invalid value for field '" + fieldName + "': '" + raw + "'"
-        );
-    }
+Orderbook loadBook(const Options& opt) {
+    Orderbook   book;
+    LoadBuffers buffers;
+    loadBook(opt, book, buffers);
+    return book;
 }
 
-Order parseRow(const std::string& line, int lineNumber) {
-    std::stringstream ss(line);
-    std::string sideStr, priceStr, sizeStr;
-
-    std::getline(ss, sideStr,  ',');
-    std::getline(ss, priceStr, ',');
-    std::getline(ss, sizeStr,  ',');
+// ---- Batch mode --------------------------------------------------------------
+
+// Fixed-size pool with one task deque per worker. Workers pop their own deque from
+// the back and, when it is empty, steal from the front of the others, so one slow
+// file does not leave the rest of a worker's queue stranded.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads)
+        : queues_(std::max(1u, threads)) {
+        for (unsigned i = 0; i < queues_.size(); i++)
+            workers_.emplace_back([this, i] { run(i); });
+    }
 
-    if (trim(sideStr).empty() || trim(priceStr).empty() || trim(sizeStr).empty())
-        throw std::invalid_argument(
-            "Line " + std::to_string(lineNumber) + " has empty fields."
-        );
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
 
-    Order order;
-    order.side  = parseSide  (trim(sideStr));
-    order.price = parseDouble(trim(priceStr), "price");
-    order.size  = parseDouble(trim(sizeStr),  "size");
-    return order;
-}
+    WorkStealingPool(const WorkStealingPool&)            = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Tasks are dealt round-robin; stealing evens out whatever imbalance remains
+    void submit(std::function<void()> task) {
+        Queue& queue = queues_[next_++ % queues_.size()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            pending_++;
+        }
+        wake_.notify_one();
+    }
 
-Orderbook loadCSV(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open())
-        throw std::runtime_error("Cannot open file: '" + filename + "'");
+    size_t size() const { return workers_.size(); }
+
+private:
+    struct Queue {
+        std::mutex                        mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool popOwn(size_t self, std::function<void()>& task) {
+        Queue& queue = queues_[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
 
-    Orderbook book;
-    std::string line;
-    int lineNumber = 0;
+    bool steal(size_t self, std::function<void()>& task) {
+        for (size_t k = 1; k < queues_.size(); k++) {
+            Queue& victim = queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty()) continue;
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
 
-    std::getline(file, line); // skip header
-    lineNumber++;
+    void run(size_t self) {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex_);
+                wake_.wait(lock, [this] { return pending_ > 0 || stopping_; });
+                if (pending_ == 0) return; // stopping and fully drained
+                pending_--;
+            }
+            // A pending count was claimed, so some deque holds a task for us
+            std::function<void()> task;
+            while (!popOwn(self, task) && !steal(self, task)) std::this_thread::yield();
+            task();
+        }
+    }
 
-    while (std::getline(file, line)) {
-        lineNumber++;
-        if (trim(line).empty()) continue;
+    std::vector<Queue>       queues_;
+    std::vector<std::thread> workers_;
+    std::mutex               wakeMutex_;
+    std::condition_variable  wake_;
+    size_t                   pending_  = 0;
+    bool                     stopping_ = false;
+    size_t                   next_     = 0;
+};
 
-        Order order = parseRow(line, lineNumber);
-        if (order.side == Side::BID) book.bids.push_back(order);
-        else                         book.asks.push_back(order);
+// A directory yields its regular files sorted by name; any other path is a manifest
+// with one file per line ('#' starts a comment line)
+std::vector<std::string> listBatchInputs(const std::string& path) {
+    std::vector<std::string> files;
+    if (std::filesystem::is_directory(path)) {
+        for (const auto& entry : std::filesystem::directory_iterator(path))
+            if (entry.is_regular_file()) files.push_back(entry.path().string());
+        std::sort(files.begin(), files.end());
+        return files;
     }
 
-    if (book.bids.empty()) throw std::runtime_error("No bids found in file.");
-    if (book.asks.empty()) throw std::runtime_error("No asks found in file.");
-
-    std::sort(book.bids.begin(), book.bids.end(),
-        [](const Order& a, const Order& b) { return a.price > b.price; });
-    std::sort(book.asks.begin(), book.asks.end(),
-        [](const Order& a, const Order& b) { return a.price < b.price; });
+    std::ifstream manifest(path);
+    if (!manifest.is_open())
+        throw std::runtime_error("Cannot open file: '" + path + "'");
+    std::string line;
+    while (std::getline(manifest, line)) {
+        std::string_view entry = trimView(line);
+        if (!entry.empty() && entry.front() != '#') files.emplace_back(entry);
+    }
+    return files;
+}
 
-    // Crossed book means the data is corrupt
-    if (book.bids[0].price >= book.asks[0].price)
-        throw std::runtime_error(
-            "Crossed book: best bid (" + std::to_string(book.bids[0].price) +
-            ") >= best ask ("          + std::to_string(book.asks[0].price) + ")."
-        );
+struct BatchResult {
+    std::string file;
+    Stats       stats{};
+    double      loadMicros = 0.0;
+    double      calcMicros = 0.0;
+    std::string error;  // empty on success
+};
 
-    return book;
+void writeBatchHeader(RecordWriter& out) {
+    std::vector<std::string> columns = metricNames();
+    columns.push_back("load_us");
+    columns.push_back("calc_us");
+    out.header("file", columns, true);
 }
 
-double calcDepth(const std::vector<Order>& orders, double minPrice, double maxPrice) {
-    double total = 0.0;
-    for (const auto& order : orders)
-        if (order.price >= minPrice && order.price <= maxPrice)
-            total += order.size;
-    return total;
+void writeBatchRow(RecordWriter& out, const BatchResult& r) {
+    std::array<double, 11> values;
+    std::array<double, 9>  stats = statsValues(r.stats);
+    std::copy(stats.begin(), stats.end(), values.begin());
+    values[9]  = r.loadMicros;
+    values[10] = r.calcMicros;
+    out.row(r.file, values, r.error);
 }
 
-// Walk asks from cheapest to most expensive, accumulate volume-weighted cost
-double calcVWAPBuy(const std::vector<Order>& asks, double targetQty) {
-    double remaining = targetQty;
-    double totalCost = 0.0;
+// Shapes, loads and analyzes one batch input; `load` fills the worker's book
+template <typename Load>
+BatchResult analyzeWith(const std::string& file, double depthPct, double targetQty, Load&& load) {
+    using Clock = std::chrono::steady_clock;
+    auto micros = [](Clock::duration d) { return std::chrono::duration<double, std::micro>(d).count(); };
 
-    for (const auto& ask : asks) {
-        if (remaining <= 0.0) break;
-        double filled  = std::min(remaining, ask.size);
-        totalCost     += filled * ask.price;
-        remaining     -= filled;
+    BatchResult result;
+    result.file = file;
+    try {
+        // Pool threads live for the whole batch, so these buffers are reused by every
+        // file a worker handles instead of being reallocated per file
+        thread_local Orderbook   book;
+        thread_local LoadBuffers buffers;
+        thread_local SoABook     soa;
+
+        auto start = Clock::now();
+        load(book, buffers);
+        auto loaded = Clock::now();
+        toSoA(book, soa);
+        result.stats      = calcStatsNoThrow(soa, depthPct, targetQty);
+        result.loadMicros = micros(loaded - start);
+        result.calcMicros = micros(Clock::now() - loaded);
+    } catch (const std::exception& e) {
+        result.error = e.what();
     }
-
-    if (remaining > 0.0)
-        throw std::runtime_error(
-            "Not enough liquidity to buy " + std::to_string(targetQty) + " units."
-        );
-    return totalCost / targetQty;
+    return result;
 }
 
-// Walk bids from most expensive to cheapest, accumulate volume-weighted revenue
-double calcVWAPSell(const std::vector<Order>& bids, double targetQty) {
-    double remaining    = targetQty;
-    double totalRevenue = 0.0;
+BatchResult analyzeFile(const std::string& file, const Options& opt, double depthPct, double targetQty) {
+    return analyzeWith(file, depthPct, targetQty, [&](Orderbook& book, LoadBuffers& buffers) {
+        Options fileOpt  = opt;
+        fileOpt.filename = file;
+        fileOpt.threads  = 1;  // parallelism comes from the pool, not from inside one file
+        loadBook(fileOpt, book, buffers);
+    });
+}
 
-    for (const auto& bid : bids) {
-        if (remaining <= 0.0) break;
-        double filled    = std::min(remaining, bid.size);
-        totalRevenue    += filled * bid.price;
-        remaining       -= filled;
-    }
+// A file the prefetcher already read: only parsing is left, so load_us excludes I/O
+BatchResult analyzePrefetched(const PrefetchedFile& file, const std::string& name, const Options& opt,
+                              double depthPct, double targetQty) {
+    return analyzeWith(name, depthPct, targetQty, [&](Orderbook& book, LoadBuffers& buffers) {
+        if (!file.error.empty())             throw std::runtime_error(file.error);
+        if (isBinarySnapshotData(file.data)) parseBinary(file.data, name, opt.shape, book);
+        else                                 parseCSV(file.data, 1, opt.shape, book, buffers);
+    });
+}
 
-    if (remaining > 0.0)
-        throw std::runtime_error(
-            "Not enough liquidity to sell " + std::to_string(targetQty) + " units."
-        );
-    return totalRevenue / targetQty;
+// Analyzes every input on a work-stealing pool. Rows are written in input order as
+// soon as each prefix completes, or in completion order when `ordered` is false.
+// With `prefetch` > 0, reader threads load files that many ahead of the workers into
+// recycled buffers, and each worker task parses whichever file is ready next.
+// Returns the number of files that failed.
+size_t runBatch(const std::vector<std::string>& files, const Options& opt, unsigned jobs, size_t prefetch,
+                bool ordered, double depthPct, double targetQty, RecordWriter& out) {
+    std::vector<std::optional<BatchResult>> results(files.size());
+    std::mutex              doneMutex;
+    std::condition_variable done;
+    size_t                  failed = 0;
+
+    auto finish = [&](size_t i, BatchResult result) {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        if (!result.error.empty()) failed++;
+        if (ordered) {
+            results[i] = std::move(result);
+            done.notify_one();
+        } else {
+            writeBatchRow(out, result);
+        }
+    };
+
+    writeBatchHeader(out);
+    {
+        std::optional<FilePrefetcher> reader;
+        if (prefetch > 0) reader.emplace(files, static_cast<unsigned>(std::min<size_t>(prefetch, 8)), prefetch);
+
+        // Declared after the prefetcher so workers stop before its readers do
+        WorkStealingPool pool(jobs);
+        for (size_t i = 0; i < files.size(); i++) {
+            if (reader) {
+                pool.submit([&] {
+                    PrefetchedFile file;
+                    if (!reader->next(file)) {
+                        // One task per file, so this means the prefetcher lost count. No
+                        // slot is known: report it out of order and let the rows arrive.
+                        BatchResult lost;
+                        lost.file  = "(prefetch)";
+                        lost.error = "Prefetcher ran out of files before every task was served";
+                        std::lock_guard<std::mutex> lock(doneMutex);
+                        failed++;
+                        writeBatchRow(out, lost);
+                        return;
+                    }
+                    BatchResult result = analyzePrefetched(file, files[file.index], opt, depthPct, targetQty);
+                    size_t index = file.index;
+                    reader->release(file);
+                    finish(index, std::move(result));
+                });
+            } else {
+                pool.submit([&, i] { finish(i, analyzeFile(files[i], opt, depthPct, targetQty)); });
+            }
+        }
+
+        if (ordered) {
+            for (size_t next = 0; next < files.size(); next++) {
+                std::unique_lock<std::mutex> lock(doneMutex);
+                done.wait(lock, [&] { return results[next].has_value(); });
+                writeBatchRow(out, *results[next]);
+                results[next].reset();
+            }
+        }
+    } // pool joins here, then the prefetcher
+    out.flush();
+    return failed;
 }
 
-Stats calcStats(const Orderbook& book, double depthPct, double targetQty) {
-    Stats s;
+// ---- Consolidated mode -------------------------------------------------------
+
+// One venue per input file (named after the file stem), all shaped the same way
+ConsolidatedBook loadVenues(const Options& opt) {
+    std::vector<std::string> files = listBatchInputs(opt.venuesPath);
+    if (files.empty()) throw std::runtime_error("No venue books found in '" + opt.venuesPath + "'");
+
+    ConsolidatedBook       consolidated;
+    std::vector<Orderbook> books(files.size());
+    LoadBuffers            buffers;
+    for (size_t i = 0; i < files.size(); i++) {
+        Options venueOpt  = opt;
+        venueOpt.filename = files[i];
+        loadBook(venueOpt, books[i], buffers);
+        consolidated.addVenue(std::filesystem::path(files[i]).stem().string());
+    }
+    consolidated.build(books);
+    return consolidated;
+}
 
-    s.bestBid   = book.bids[0].price;
-    s.bestAsk   = book.asks[0].price;
-    s.midPrice  = (s.bestBid + s.bestAsk) / 2.0;
-    s.spread    = s.bestAsk - s.bestBid;
-    s.spreadPct = (s.spread / s.midPrice) * 100.0;
+// ---- History replay ----------------------------------------------------------
+
+// Writes one row per stored snapshot in [--from, --to]. Without shaping flags only
+// the time and stats columns are decoded. Shaping flags decode the levels and
+// recompute the stats; a lone --top N decodes just the best N levels per side.
+size_t runReplay(const Options& opt, double depthPct, double targetQty, RecordWriter& out,
+                 RollingStats* rolling) {
+    HistoryReader history(opt.replayPath);
+    HistoryQuery  query;
+    query.from = opt.replayFrom;
+    query.to   = opt.replayTo;
+
+    const BookShape& shape = opt.shape;
+    bool reshape = shape.aggregate || shape.bucket > 0.0 || shape.topLevels > 0 || shape.bandPct > 0.0;
+    if (reshape) {
+        query.columns = HISTORY_BIDS | HISTORY_ASKS;
+        if (!shape.aggregate && shape.bucket <= 0.0 && shape.bandPct <= 0.0) query.maxLevels = shape.topLevels;
+    }
 
-    double lower = s.midPrice * (1.0 - depthPct / 100.0);
-    double upper = s.midPrice * (1.0 + depthPct / 100.0);
-    s.bidDepth  = calcDepth(book.bids, lower, upper);
-    s.askDepth  = calcDepth(book.asks, lower, upper);
+    std::vector<std::string> columns = metricNames();
+    if (rolling) {
+        std::vector<std::string> extra = rollingNames();
+        columns.insert(columns.end(), extra.begin(), extra.end());
+    }
+    out.header("snapshot", columns, false);
 
-    s.vwapBuy   = calcVWAPBuy (book.asks, targetQty);
-    s.vwapSell  = calcVWAPSell(book.bids, targetQty);
+    Orderbook book;
+    SoABook   soa;
+    size_t visited = history.replay(query, [&](const HistoryRecord& record) {
+        Stats stats = record.stats;
+        if (reshape) {
+            book.bids.assign(record.book.bids.begin(), record.book.bids.end());
+            book.asks.assign(record.book.asks.begin(), record.book.asks.end());
+            finalizeBook(book, shape);
+            toSoA(book, soa);
+            stats = calcStatsNoThrow(soa, depthPct, targetQty);
+        }
+
+        std::array<double, 9 + RollingStats::COLUMNS> values;
+        auto head = statsValues(stats);
+        size_t count = std::copy(head.begin(), head.end(), values.begin()) - values.begin();
+        if (rolling) {
+            rolling->add(static_cast<double>(record.timestamp), stats);
+            auto tail = rolling->values();
+            count = std::copy(tail.begin(), tail.end(), values.begin() + count) - values.begin();
+        }
+        out.row(std::to_string(record.timestamp), std::span<const double>(values.data(), count));
+    });
+    out.flush();
+    return visited;
+}
 
-    return s;
+// ---- Live feed mode ----------------------------------------------------------
+
+volatile std::sig_atomic_t feedInterrupted = 0;
+
+// Runs the UDP pipeline and prints the published stats every feedEveryMs until
+// feedSeconds elapse or SIGINT. Reading the seqlock never blocks the book thread.
+void runFeed(const Options& opt, double depthPct, double targetQty) {
+    using Clock = std::chrono::steady_clock;
+
+    Orderbook snapshot;
+    if (opt.filenameSet) snapshot = loadBook(opt);
+
+    FeedConfig config;
+    config.port      = static_cast<uint16_t>(opt.feedPort);
+    config.depthPct  = depthPct;
+    config.targetQty = targetQty;
+    FeedPipeline feed(config, snapshot);
+    std::cerr << "Listening for level updates on UDP port " << feed.port() << "\n";
+
+    std::signal(SIGINT, [](int) { feedInterrupted = 1; });
+    std::ios::sync_with_stdio(false);
+    RecordWriter out(std::cout, opt.format.value_or(OutputFormat::CSV));
+    std::vector<std::string> columns = metricNames();
+    columns.push_back("updates");
+    columns.push_back("parse_errors");
+    columns.push_back("latency_us");
+    out.header("elapsed_ms", columns, false);
+
+    feed.start();
+    auto start = Clock::now();
+    auto every = std::chrono::duration<double, std::milli>(opt.feedEveryMs);
+    for (auto next = start + std::chrono::duration_cast<Clock::duration>(every); !feedInterrupted;
+         next += std::chrono::duration_cast<Clock::duration>(every)) {
+        while (!feedInterrupted && Clock::now() < next)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+        FeedSnapshot snap = feed.latest();
+        const double NaN = std::numeric_limits<double>::quiet_NaN();
+        std::array<double, 12> values;
+        std::array<double, 9>  stats = statsValues(snap.stats);
+        for (size_t i = 0; i < stats.size(); i++) values[i] = snap.valid ? stats[i] : NaN;
+        values[9]  = static_cast<double>(snap.updates);
+        values[10] = static_cast<double>(snap.parseErrors);
+        values[11] = snap.latencyNanos / 1000.0;
+
+        double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        char   key[32];
+        std::snprintf(key, sizeof(key), "%.0f", elapsed);
+        out.row(key, values);
+        out.flush();
+        if (opt.feedSeconds > 0.0 && elapsed >= opt.feedSeconds * 1000.0) break;
+    }
+    feed.stop();
 }
 
-void printStats(const Stats& s, double depthPct, double targetQty) {
-    std::cout << std::fixed << std::setprecision(4);
-    std::cout << "\n============================================\n";
-    std::cout << "         ORDERBOOK ANALYSIS\n";
-    std::cout << "============================================\n";
-    std::cout << "  Best Bid    : " << s.bestBid  << "\n";
-    std::cout << "  Best Ask    : " << s.bestAsk  << "\n";
-    std::cout << "  Mid Price   : " << s.midPrice << "\n";
-    std::cout << "  Spread      : " << s.spread << "  (" << s.spreadPct << "%)\n";
-    std::cout << "--------------------------------------------\n";
-    std::cout << "  Depth (±"   << depthPct << "% from mid):\n";
-    std::cout << "    Bids : "  << s.bidDepth << " units\n";
-    std::cout << "    Asks : "  << s.askDepth << " units\n";
-    std::cout << "--------------------------------------------\n";
-    std::cout << "  VWAP (qty = " << targetQty << " units):\n";
-    std::cout << "    Buy  : "  << s.vwapBuy  << "\n";
-    std::cout << "    Sell : "  << s.vwapSell << "\n";
-    std::cout << "============================================\n\n";
+// ---- Server mode -------------------------------------------------------------
+
+volatile std::sig_atomic_t serverInterrupted = 0;
+
+// Keeps books resident and answers the server.h protocol on a Unix socket until
+// SHUTDOWN, SIGINT or SIGTERM. An input file given on the command line is preloaded,
+// named after its stem. Every LOAD goes through loadBook, so the loader and shaping
+// flags given here apply to all books the server holds.
+void runServer(const Options& opt) {
+    LoadBuffers buffers;
+    BookServer  books([&](const std::string& path, Orderbook& book) {
+        Options bookOpt  = opt;
+        bookOpt.filename = path;
+        loadBook(bookOpt, book, buffers);
+    });
+    if (opt.filenameSet) books.load(std::filesystem::path(opt.filename).stem().string(), opt.filename);
+
+    SocketServer server(books, opt.servePath);
+    std::cerr << "Serving queries on " << opt.servePath << "\n";
+    std::signal(SIGINT,  [](int) { serverInterrupted = 1; });
+    std::signal(SIGTERM, [](int) { serverInterrupted = 1; });
+    while (!serverInterrupted && server.poll(100)) {}
 }
 
+// Prints the --profile summary however main exits, once all worker threads are done
+struct ProfileReport {
+    ~ProfileReport() {
+        if (profilingEnabled()) printProfile(std::cerr);
+    }
+};
+
 int main(int argc, const char * argv[]) {
 
-    const std::string default_FILENAME = "orderbook.csv";
-    std::string FILENAME = default_FILENAME;
-    if(argc > 1){
-        FILENAME = argv[1];
-    }
     const double      DEPTH_PCT  = 0.5;   // ±0.5% from mid price
     const double      TARGET_QTY = 40.0;  // quantity for VWAP calculation
 
     try {
-        Orderbook book  = loadCSV(FILENAME);
-        Stats     stats = calcStats(book, DEPTH_PCT, TARGET_QTY);
+        Options opt = parseOptions(argc, argv);
+        if (opt.help) {
+            std::cout << USAGE;
+            return 0;
+        }
+        selectKernels(opt.kernels);
+        ProfileReport report;
+        if (opt.profile) enableProfiling();
+
+        if (!opt.batchPath.empty()) {
+            std::ios::sync_with_stdio(false);
+            std::vector<std::string> files = listBatchInputs(opt.batchPath);
+            RecordWriter out(std::cout, opt.format.value_or(OutputFormat::CSV));
+            unsigned jobs   = opt.jobs ? opt.jobs : std::max(1u, std::thread::hardware_concurrency());
+            auto     start  = std::chrono::steady_clock::now();
+            size_t   failed = runBatch(files, opt, jobs, opt.prefetch, !opt.unordered, DEPTH_PCT, TARGET_QTY, out);
+            double   wall   = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cerr << "Analyzed " << files.size() << " files (" << failed << " failed) in "
+                      << std::fixed << std::setprecision(3) << wall << " s\n";
+            return failed ? 1 : 0;
+        }
+
+        if (!opt.venuesPath.empty()) {
+            printConsolidated(loadVenues(opt), TARGET_QTY);
+            return 0;
+        }
+
+        if (opt.feedPort >= 0) {
+            runFeed(opt, DEPTH_PCT, TARGET_QTY);
+            return 0;
+        }
+
+        if (!opt.servePath.empty()) {
+            runServer(opt);
+            return 0;
+        }
+
+        if (!opt.queryPath.empty()) {
+            queryServer(opt.queryPath, std::cin, std::cout);
+            return 0;
+        }
+
+        std::optional<RollingStats> rolling;
+        if (opt.rollingWindow > 0.0) rolling.emplace(opt.rollingWindow);
+        RollingStats* roll = rolling ? &*rolling : nullptr;
+
+        if (!opt.replayPath.empty()) {
+            std::ios::sync_with_stdio(false);
+            RecordWriter out(std::cout, opt.format.value_or(OutputFormat::CSV));
+            runReplay(opt, DEPTH_PCT, TARGET_QTY, out, roll);
+            return 0;
+        }
+
+        if (opt.stream) {
+            std::ios::sync_with_stdio(false);
+            RecordWriter out(std::cout, opt.format.value_or(OutputFormat::CSV));
+            std::optional<HistoryWriter> history;
+            if (!opt.recordPath.empty()) history.emplace(opt.recordPath, opt.tickSize, opt.lotSize);
+            HistoryWriter* record = history ? &*history : nullptr;
+            if (opt.filename == "-") {
+                streamSnapshots(std::cin, out, DEPTH_PCT, TARGET_QTY, opt.shape, roll, record);
+            } else {
+                std::ifstream file(opt.filename);
+                if (!file.is_open())
+                    throw std::runtime_error("Cannot open file: '" + opt.filename + "'");
+                streamSnapshots(file, out, DEPTH_PCT, TARGET_QTY, opt.shape, roll, record);
+            }
+            if (history) history->finish();
+            return 0;
+        }
+
+        Orderbook book = loadBook(opt);
+        if (!opt.convertTo.empty()) {
+            saveBinary(book, opt.convertTo);
+            std::cout << "Converted " << opt.filename << " -> " << opt.convertTo
+                      << " (" << book.bids.size() << " bids + " << book.asks.size() << " asks)\n";
+            return 0;
+        }
+
+        if (!opt.deltasFile.empty()) {
+            IncrementalBook live(DEPTH_PCT);
+            live.reset(book);
+            size_t applied = applyUpdatesCSV(live, opt.deltasFile);
+            std::cout << "Applied " << applied << " updates from " << opt.deltasFile << "\n";
+            printStats(live.stats(TARGET_QTY), DEPTH_PCT, TARGET_QTY);
+            return 0;
+        }
+
+        if (!opt.metrics.empty()) {
+            LazyStats stats(book, DEPTH_PCT, TARGET_QTY);
+            std::cout << std::fixed << std::setprecision(4);
+            for (const auto& name : opt.metrics) {
+                std::optional<double> value = readMetric(stats, name);
+                std::cout << name << " = ";
+                if (value) std::cout << *value << "\n";
+                else       std::cout << "n/a (not enough liquidity for " << TARGET_QTY << " units)\n";
+            }
+            return 0;
+        }
+
+        if (opt.fixed) {
+            FixedBook fixed = toFixed(book, opt.tickSize, opt.lotSize);
+            std::cout << "Fixed-point: tick = " << fixed.tickSize << ", lot = " << fixed.lotSize << "\n";
+            printStats(calcStatsFixed(fixed, DEPTH_PCT, TARGET_QTY), DEPTH_PCT, TARGET_QTY);
+            return 0;
+        }
+
+        SoABook   soa   = toSoA(book);
+        if (opt.format) {
+            RecordWriter out(std::cout, *opt.format);
+            out.header("file", metricNames(), false);
+            out.row(opt.filename, statsValues(calcStatsNoThrow(soa, DEPTH_PCT, TARGET_QTY)));
+            return 0;
+        }
+
+        Stats     stats = calcStats(soa, DEPTH_PCT, TARGET_QTY);
         printStats(stats, DEPTH_PCT, TARGET_QTY);
+        if (!opt.depthCurvePcts.empty()) printDepthCurve(calcDepthCurve(soa, opt.depthCurvePcts));
+        if (!opt.impactQtys.empty())     printImpactCurve(calcImpactCurve(soa, opt.impactQtys));
+        if (!opt.slippageBps.empty())    printSlippageCapacity(calcSlippageCapacity(soa, opt.slippageBps));
+        if (!opt.movePrices.empty())     printPriceMoves(calcPriceMoves(soa, opt.movePrices));
     }
     catch (const std::exception& e) {
         std::cerr << "\n[ERROR] " << e.what() << "\n\n";
@@ -230,4 +732,4 @@ int main(int argc, const char * argv[]) {
     }
 
     return 0;
-}
\ No newline at end of file
+}
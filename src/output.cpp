@@ -0,0 +1,127 @@
+#include "orderbook/output.h"
+
+#include "orderbook/consolidated.h"
+#include "orderbook/cost.h"
+
+#include <stdexcept>
+#include <iomanip>
+#include <iostream>
+
+void printStats(const Stats& s, double depthPct, double targetQty) {
+    ProfileScope scope(Stage::OUTPUT);
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "\n============================================\n";
+    std::cout << "         ORDERBOOK ANALYSIS\n";
+    std::cout << "============================================\n";
+    std::cout << "  Best Bid    : " << s.bestBid  << "\n";
+    std::cout << "  Best Ask    : " << s.bestAsk  << "\n";
+    std::cout << "  Mid Price   : " << s.midPrice << "\n";
+    std::cout << "  Spread      : " << s.spread << "  (" << s.spreadPct << "%)\n";
+    std::cout << "--------------------------------------------\n";
+    std::cout << "  Depth (±"   << depthPct << "% from mid):\n";
+    std::cout << "    Bids : "  << s.bidDepth << " units\n";
+    std::cout << "    Asks : "  << s.askDepth << " units\n";
+    std::cout << "--------------------------------------------\n";
+    std::cout << "  VWAP (qty = " << targetQty << " units):\n";
+    std::cout << "    Buy  : "  << s.vwapBuy  << "\n";
+    std::cout << "    Sell : "  << s.vwapSell << "\n";
+    std::cout << "============================================\n\n";
+}
+
+void printDepthCurve(const std::vector<DepthPoint>& curve) {
+    ProfileScope scope(Stage::OUTPUT);
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "  Depth curve (±% from mid):\n";
+    for (const auto& point : curve)
+        std::cout << "    " << std::setw(8) << point.depthPct << "%  bids "
+                  << std::setw(14) << point.bidDepth << "  asks " << std::setw(14) << point.askDepth << "\n";
+    std::cout << "\n";
+}
+
+void printImpactCurve(const std::vector<ImpactPoint>& curve) {
+    ProfileScope scope(Stage::OUTPUT);
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "  Impact curve (VWAP, slippage vs mid):\n";
+    for (const auto& point : curve)
+        std::cout << "    qty " << std::setw(12) << point.qty
+                  << "  buy "  << std::setw(12) << point.vwapBuy  << " (" << point.buySlippagePct  << "%)"
+                  << "  sell " << std::setw(12) << point.vwapSell << " (" << point.sellSlippagePct << "%)\n";
+    std::cout << "\n";
+}
+
+void printSlippageCapacity(const std::vector<SlippagePoint>& points) {
+    ProfileScope scope(Stage::OUTPUT);
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "  Max size within slippage (VWAP vs mid):\n";
+    for (const auto& point : points)
+        std::cout << "    " << std::setw(8) << point.bps << " bps"
+                  << "  buy "  << std::setw(14) << point.buyQty  << " @ " << point.buyVWAP
+                  << "  sell " << std::setw(14) << point.sellQty << " @ " << point.sellVWAP << "\n";
+    std::cout << "\n";
+}
+
+void printPriceMoves(const std::vector<PriceMovePoint>& moves) {
+    ProfileScope scope(Stage::OUTPUT);
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "  Cost to move the touch:\n";
+    for (const auto& move : moves) {
+        std::cout << "    to " << std::setw(12) << move.price;
+        if (move.cost.qty == 0.0) {
+            std::cout << "  already there\n";
+            continue;
+        }
+        std::cout << (move.side == Side::ASK ? "  buy  " : "  sell ") << std::setw(14) << move.cost.qty
+                  << " for " << move.cost.notional << " (VWAP " << move.cost.vwap << ")"
+                  << (move.cost.complete ? "" : "  — side exhausted") << "\n";
+    }
+    std::cout << "\n";
+}
+
+void printConsolidated(const ConsolidatedBook& book, double targetQty) {
+    ConsolidatedStats s = book.stats(targetQty);
+    ProfileScope scope(Stage::OUTPUT);
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "\n============================================\n";
+    std::cout << "     CONSOLIDATED BOOK (" << book.venueCount() << " venues)\n";
+    std::cout << "============================================\n";
+    std::cout << "  Best Bid    : " << s.bestBid << "  @ " << book.venueName(s.bestBidVenue) << "\n";
+    std::cout << "  Best Ask    : " << s.bestAsk << "  @ " << book.venueName(s.bestAskVenue) << "\n";
+    std::cout << "  Mid Price   : " << s.midPrice << "\n";
+    std::cout << "  Spread      : " << s.spread << "  (" << s.spreadPct << "%)\n";
+    std::cout << "--------------------------------------------\n";
+    std::cout << "  Arbitrage   : " << s.arbQty << " units, profit " << s.arbProfit << "\n";
+    std::cout << "--------------------------------------------\n";
+    std::cout << "  VWAP (qty = " << targetQty << " units):\n";
+    std::cout << "    Buy  : "  << s.vwapBuy  << "\n";
+    std::cout << "    Sell : "  << s.vwapSell << "\n";
+    std::cout << "--------------------------------------------\n";
+    std::cout << "  Fill by venue        buy        sell\n";
+    std::vector<double> buys, sells;
+    book.fillByVenue(Side::ASK, targetQty, buys);
+    book.fillByVenue(Side::BID, targetQty, sells);
+    for (uint32_t v = 0; v < book.venueCount(); v++)
+        std::cout << "    " << std::left << std::setw(12) << book.venueName(v) << std::right
+                  << std::setw(10) << buys[v] << "  " << std::setw(10) << sells[v] << "\n";
+    std::cout << "============================================\n\n";
+}
+
+OutputFormat parseOutputFormat(std::string_view name) {
+    if (name == "csv")    return OutputFormat::CSV;
+    if (name == "tsv")    return OutputFormat::TSV;
+    if (name == "jsonl")  return OutputFormat::JSONL;
+    if (name == "binary") return OutputFormat::BINARY;
+    throw std::invalid_argument("Unknown output format: '" + std::string(name) + "'");
+}
+
+const std::vector<std::string>& metricNames() {
+    static const std::vector<std::string> names = {
+        "best_bid", "best_ask", "mid", "spread", "spread_pct",
+        "bid_depth", "ask_depth", "vwap_buy", "vwap_sell",
+    };
+    return names;
+}
+
+std::array<double, 9> statsValues(const Stats& s) {
+    return {s.bestBid, s.bestAsk, s.midPrice, s.spread, s.spreadPct,
+            s.bidDepth, s.askDepth, s.vwapBuy, s.vwapSell};
+}
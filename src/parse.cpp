@@ -0,0 +1,89 @@
+#include "orderbook/parse.h"
+
+#include <stdexcept>
+#include <cmath>
+#include <charconv>
+
+std::string_view trimView(std::string_view s) {
+    const std::string_view ws = " \t\r\n";
+    size_t start = s.find_first_not_of(ws);
+    if (start == std::string_view::npos) return {};
+    size_t end = s.find_last_not_of(ws);
+    return s.substr(start, end - start + 1);
+}
+
+std::string trim(const std::string& s) {
+    return std::string(trimView(s));
+}
+
+bool tryParseSide(std::string_view raw, Side& side) noexcept {
+    auto equalsIgnoreCase = [&raw](std::string_view word) {
+        if (raw.size() != word.size()) return false;
+        for (size_t i = 0; i < raw.size(); i++)
+            if (::tolower(static_cast<unsigned char>(raw[i])) != word[i]) return false;
+        return true;
+    };
+    if      (equalsIgnoreCase("bid")) side = Side::BID;
+    else if (equalsIgnoreCase("ask")) side = Side::ASK;
+    else                              return false;
+    return true;
+}
+
+Side parseSide(std::string_view raw) {
+    Side side;
+    if (!tryParseSide(raw, side))
+        throw std::invalid_argument("Unknown order side: '" + std::string(raw) + "'");
+    return side;
+}
+
+bool tryParseDouble(std::string_view raw, double& value, bool allowZero) noexcept {
+    const char* first = raw.data();
+    const char* last  = raw.data() + raw.size();
+    if (first != last && *first == '+') first++;
+
+    value = 0.0;
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    bool inRange = allowZero ? value >= 0.0 : value > 0.0;
+    return ec == std::errc() && ptr != first && std::isfinite(value) && inRange;
+}
+
+double parseDouble(std::string_view raw, std::string_view fieldName, bool allowZero) {
+    double value;
+    if (!tryParseDouble(raw, value, allowZero))
+        throw std::invalid_argument(
+            "Invalid value for field '" + std::string(fieldName) + "': '" + std::string(raw) + "'"
+        );
+    return value;
+}
+
+std::string_view nextField(std::string_view& rest) {
+    size_t comma = rest.find(',');
+    std::string_view field = rest.substr(0, comma);
+    rest = (comma == std::string_view::npos) ? std::string_view{} : rest.substr(comma + 1);
+    return field;
+}
+
+Order parseRow(std::string_view line, int lineNumber) {
+    std::string_view rest     = line;
+    std::string_view sideStr  = trimView(nextField(rest));
+    std::string_view priceStr = trimView(nextField(rest));
+    std::string_view sizeStr  = trimView(nextField(rest));
+
+    if (sideStr.empty() || priceStr.empty() || sizeStr.empty())
+        throw std::invalid_argument(
+            "Line " + std::to_string(lineNumber) + " has empty fields."
+        );
+
+    Order order;
+    order.side  = parseSide  (sideStr);
+    order.price = parseDouble(priceStr, "price");
+    order.size  = parseDouble(sizeStr,  "size");
+    return order;
+}
+
+std::vector<double> parseDoubleList(std::string_view list, std::string_view fieldName) {
+    std::vector<double> values;
+    while (!list.empty())
+        values.push_back(parseDouble(trimView(nextField(list)), fieldName));
+    return values;
+}
@@ -0,0 +1,94 @@
+#include "orderbook/prefetch.h"
+
+#include "orderbook/profile.h"
+
+#include <algorithm>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool readWholeFile(const std::string& filename, std::string& out, std::string& error) {
+    ProfileScope scope(Stage::READ);
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || ::fstat(fd, &st) != 0) {
+        if (fd >= 0) ::close(fd);
+        error = "Cannot open file: '" + filename + "'";
+        return false;
+    }
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    out.resize(static_cast<size_t>(st.st_size));
+    size_t filled = 0;
+    while (filled < out.size()) {
+        ssize_t n = ::read(fd, out.data() + filled, out.size() - filled);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        filled += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    if (filled != out.size()) {
+        error = "Cannot read file: '" + filename + "'";
+        return false;
+    }
+    return true;
+}
+
+FilePrefetcher::FilePrefetcher(std::vector<std::string> files, unsigned readers, size_t depth)
+    : files_(std::move(files)), free_(std::max<size_t>(depth, 1)) {
+    unsigned count = std::clamp<unsigned>(readers, 1, static_cast<unsigned>(free_.size()));
+    for (unsigned i = 0; i < count; i++) readers_.emplace_back([this] { readLoop(); });
+}
+
+FilePrefetcher::~FilePrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    freed_.notify_all();
+    for (auto& reader : readers_) reader.join();
+}
+
+void FilePrefetcher::readLoop() {
+    for (;;) {
+        PrefetchedFile file;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            freed_.wait(lock, [this] { return stopping_ || nextRead_ == files_.size() || !free_.empty(); });
+            if (stopping_ || nextRead_ == files_.size()) return;
+            file.index = nextRead_++;
+            file.data.swap(free_.back());
+            free_.pop_back();
+        }
+
+        // The actual I/O runs unlocked, so readers overlap each other and the consumers
+        readWholeFile(files_[file.index], file.data, file.error);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_.push_back(std::move(file));
+        }
+        ready_.notify_one();
+    }
+}
+
+bool FilePrefetcher::next(PrefetchedFile& file) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (handedOut_ == files_.size()) return false;
+    handedOut_++;
+    ready_.wait(lock, [this] { return !done_.empty(); });
+    file = std::move(done_.front());
+    done_.pop_front();
+    return true;
+}
+
+void FilePrefetcher::release(PrefetchedFile& file) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(std::move(file.data));
+        file.data = std::string();
+    }
+    freed_.notify_one();
+}
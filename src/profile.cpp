@@ -0,0 +1,126 @@
+#include "orderbook/profile.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+
+namespace {
+
+// One thread's counters. Only the owning thread writes them (relaxed load + store,
+// no locked RMW); the summary reads them from any thread.
+struct ThreadCounters {
+    std::array<std::atomic<uint64_t>, STAGE_COUNT> ticks{};
+    std::array<std::atomic<uint64_t>, STAGE_COUNT> calls{};
+
+    ThreadCounters();
+    ~ThreadCounters();
+};
+
+// Live threads are read in place; an exiting thread folds its counts into `retired`
+struct ProfileRegistry {
+    std::mutex                         mutex;
+    std::vector<ThreadCounters*>       live;
+    std::array<uint64_t, STAGE_COUNT>  retiredTicks{};
+    std::array<uint64_t, STAGE_COUNT>  retiredCalls{};
+    size_t                             retiredThreads = 0;
+
+    uint64_t                              startTicks = 0;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+ProfileRegistry& registry() {
+    static ProfileRegistry* instance = new ProfileRegistry;  // never destroyed: threads may outlive main
+    return *instance;
+}
+
+ThreadCounters::ThreadCounters() {
+    ProfileRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.live.push_back(this);
+}
+
+ThreadCounters::~ThreadCounters() {
+    ProfileRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (size_t s = 0; s < STAGE_COUNT; s++) {
+        r.retiredTicks[s] += ticks[s].load(std::memory_order_relaxed);
+        r.retiredCalls[s] += calls[s].load(std::memory_order_relaxed);
+    }
+    r.retiredThreads++;
+    r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+}
+
+} // namespace
+
+const char* stageName(Stage stage) {
+    switch (stage) {
+    case Stage::READ:   return "read";
+    case Stage::PARSE:  return "parse";
+    case Stage::SORT:   return "sort/shape";
+    case Stage::SOA:    return "soa";
+    case Stage::DEPTH:  return "depth";
+    case Stage::VWAP:   return "vwap";
+    case Stage::OUTPUT: return "output";
+    case Stage::COUNT:  break;
+    }
+    return "?";
+}
+
+void enableProfiling() {
+    ProfileRegistry& r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.startTicks = readTicks();
+        r.startTime  = std::chrono::steady_clock::now();
+    }
+    profilingOn.store(true, std::memory_order_relaxed);
+}
+
+void profileRecord(Stage stage, uint64_t ticks) {
+    thread_local ThreadCounters counters;
+    size_t s = static_cast<size_t>(stage);
+    counters.ticks[s].store(counters.ticks[s].load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+    counters.calls[s].store(counters.calls[s].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+ProfileSummary profileSummary() {
+    ProfileRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    // Calibrate over the whole profiled interval: ticks per second of steady_clock
+    double wall    = std::chrono::duration<double>(std::chrono::steady_clock::now() - r.startTime).count();
+    double elapsed = static_cast<double>(readTicks() - r.startTicks);
+    double perTick = wall > 0.0 && elapsed > 0.0 ? wall / elapsed : 0.0;
+
+    std::array<uint64_t, STAGE_COUNT> ticks = r.retiredTicks, calls = r.retiredCalls;
+    size_t threads = r.retiredThreads;
+    for (const ThreadCounters* t : r.live) {
+        for (size_t s = 0; s < STAGE_COUNT; s++) {
+            ticks[s] += t->ticks[s].load(std::memory_order_relaxed);
+            calls[s] += t->calls[s].load(std::memory_order_relaxed);
+        }
+        threads++;
+    }
+
+    ProfileSummary summary{wall, threads, {}};
+    for (size_t s = 0; s < STAGE_COUNT; s++)
+        summary.stages.push_back({static_cast<Stage>(s), ticks[s] * perTick, calls[s]});
+    return summary;
+}
+
+void printProfile(std::ostream& out) {
+    ProfileSummary summary = profileSummary();
+    out << std::fixed << std::setprecision(3);
+    out << "\nProfile (" << summary.threads << " thread" << (summary.threads == 1 ? "" : "s")
+        << ", wall " << summary.wallSeconds * 1e3 << " ms):\n";
+    out << "  stage             ms     % wall        calls      us/call\n";
+    for (const auto& stage : summary.stages) {
+        if (stage.calls == 0) continue;
+        double pct = summary.wallSeconds > 0.0 ? stage.seconds / summary.wallSeconds * 100.0 : 0.0;
+        out << "  " << std::left << std::setw(10) << stageName(stage.stage) << std::right
+            << std::setw(12) << stage.seconds * 1e3 << std::setw(10) << std::setprecision(1) << pct
+            << std::setw(13) << stage.calls << std::setw(13) << std::setprecision(3)
+            << stage.seconds * 1e6 / static_cast<double>(stage.calls) << "\n";
+    }
+    out << "\n";
+}
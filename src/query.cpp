@@ -0,0 +1,120 @@
+#include "orderbook/query.h"
+
+#include "orderbook/calc.h"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+template <typename L>
+double depthOf(Side side, std::span<const L> levels, double minPrice, double maxPrice) {
+    return side == Side::BID ? calcDepthRun<Side::BID>(levels, minPrice, maxPrice)
+                             : calcDepthRun<Side::ASK>(levels, minPrice, maxPrice);
+}
+
+template <typename L>
+QueryStatus vwapOf(std::span<const L> levels, double targetQty, double& vwap) {
+    if (!(targetQty > 0.0) || !std::isfinite(targetQty)) return QueryStatus::INVALID_ARGUMENT;
+    auto fill = fillLevels(levels, targetQty);
+    if (fill.remaining > 0.0) return QueryStatus::NOT_ENOUGH_LIQUIDITY;
+    vwap = fill.notional / targetQty;
+    return QueryStatus::OK;
+}
+
+// Same definitions as calcTopOfBook + calcStats, on spans and without exceptions
+template <typename L>
+QueryStatus statsOf(BasicBookView<L> book, double depthPct, double targetQty, Stats& out) {
+    if (book.bids.empty() || book.asks.empty())   return QueryStatus::EMPTY_BOOK;
+    if (book.bids[0].price >= book.asks[0].price) return QueryStatus::CROSSED_BOOK;
+    if (!(depthPct >= 0.0) || !(targetQty > 0.0) || !std::isfinite(targetQty))
+        return QueryStatus::INVALID_ARGUMENT;
+
+    Stats s;
+    s.bestBid   = book.bids[0].price;
+    s.bestAsk   = book.asks[0].price;
+    s.midPrice  = (s.bestBid + s.bestAsk) / 2.0;
+    s.spread    = s.bestAsk - s.bestBid;
+    s.spreadPct = (s.spread / s.midPrice) * 100.0;
+
+    double lower = s.midPrice * (1.0 - depthPct / 100.0);
+    double upper = s.midPrice * (1.0 + depthPct / 100.0);
+    s.bidDepth  = calcDepthRun<Side::BID>(book.bids, lower, upper);
+    s.askDepth  = calcDepthRun<Side::ASK>(book.asks, lower, upper);
+
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+    s.vwapBuy  = s.vwapSell = NaN;
+    QueryStatus buy  = vwapOf(book.asks, targetQty, s.vwapBuy);
+    QueryStatus sell = vwapOf(book.bids, targetQty, s.vwapSell);
+
+    out = s;
+    return buy == QueryStatus::OK && sell == QueryStatus::OK ? QueryStatus::OK
+                                                             : QueryStatus::NOT_ENOUGH_LIQUIDITY;
+}
+
+} // namespace
+
+double queryDepth(Side side, std::span<const Level> levels, double minPrice, double maxPrice) noexcept {
+    return depthOf(side, levels, minPrice, maxPrice);
+}
+
+double queryDepth(Side side, std::span<const Order> levels, double minPrice, double maxPrice) noexcept {
+    return depthOf(side, levels, minPrice, maxPrice);
+}
+
+QueryStatus queryVWAP(std::span<const Level> levels, double targetQty, double& vwap) noexcept {
+    return vwapOf(levels, targetQty, vwap);
+}
+
+QueryStatus queryVWAP(std::span<const Order> levels, double targetQty, double& vwap) noexcept {
+    return vwapOf(levels, targetQty, vwap);
+}
+
+QueryStatus queryVWAPs(std::span<const Level> levels, std::span<const double> sortedQtys,
+                       std::span<double> vwaps) noexcept {
+    if (vwaps.size() != sortedQtys.size()) return QueryStatus::INVALID_ARGUMENT;
+    for (size_t k = 0; k < sortedQtys.size(); k++)
+        if (!(sortedQtys[k] > 0.0) || !std::isfinite(sortedQtys[k]) ||
+            (k > 0 && sortedQtys[k - 1] > sortedQtys[k]))
+            return QueryStatus::INVALID_ARGUMENT;
+
+    // Cursor over levels: `level` is the first level not fully consumed by `qty`
+    QueryStatus status   = QueryStatus::OK;
+    size_t      level    = 0;
+    double      cumSize  = 0.0;   // total size of levels [0, level)
+    double      notional = 0.0;   // their total notional
+    for (size_t k = 0; k < sortedQtys.size(); k++) {
+        double qty = sortedQtys[k];
+        while (level < levels.size() && cumSize + levels[level].size < qty) {
+            cumSize  += levels[level].size;
+            notional += levels[level].size * levels[level].price;
+            level++;
+        }
+        if (level == levels.size()) {
+            vwaps[k] = std::numeric_limits<double>::quiet_NaN();
+            status   = QueryStatus::NOT_ENOUGH_LIQUIDITY;
+            continue;
+        }
+        vwaps[k] = (notional + (qty - cumSize) * levels[level].price) / qty;
+    }
+    return status;
+}
+
+QueryStatus queryStats(BookView book, double depthPct, double targetQty, Stats& out) noexcept {
+    return statsOf(book, depthPct, targetQty, out);
+}
+
+QueryStatus queryStats(OrderbookView book, double depthPct, double targetQty, Stats& out) noexcept {
+    return statsOf(book, depthPct, targetQty, out);
+}
+
+const char* queryStatusName(QueryStatus status) noexcept {
+    switch (status) {
+    case QueryStatus::OK:                   return "ok";
+    case QueryStatus::EMPTY_BOOK:           return "empty book";
+    case QueryStatus::CROSSED_BOOK:         return "crossed book";
+    case QueryStatus::NOT_ENOUGH_LIQUIDITY: return "not enough liquidity";
+    case QueryStatus::INVALID_ARGUMENT:     return "invalid argument";
+    }
+    return "unknown";
+}
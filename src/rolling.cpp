@@ -0,0 +1,133 @@
+#include "orderbook/rolling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+uint32_t LogHistogram::binOf(double value) {
+    if (!(value > MIN_VALUE)) return 0;
+    double bin = 1.0 + std::floor(std::log(value / MIN_VALUE) / std::log(GROWTH));
+    return static_cast<uint32_t>(std::min(bin, static_cast<double>(BINS - 1)));
+}
+
+double LogHistogram::quantile(double q) const {
+    if (total_ == 0) return std::numeric_limits<double>::quiet_NaN();
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(total_)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen  = 0;
+    uint32_t block = 0;
+    while (seen + blocks_[block] < rank) seen += blocks_[block++];
+    uint32_t bin = block * BLOCK;
+    while (seen + counts_[bin] < rank) seen += counts_[bin++];
+
+    return bin == 0 ? 0.0 : MIN_VALUE * std::pow(GROWTH, bin - 0.5);
+}
+
+RollingStats::RollingStats(double window) : window_(window) {
+    if (!(window > 0.0)) throw std::invalid_argument("Rolling window must be > 0.");
+}
+
+void RollingStats::add(double time, const Stats& stats) {
+    if (!samples_.empty()) {
+        const Sample& last = samples_.back();
+        if (time < last.time)
+            throw std::invalid_argument("Snapshot time " + std::to_string(time) +
+                                        " is earlier than the previous one (" +
+                                        std::to_string(last.time) + ").");
+        // The previous snapshot's spread held until now: close its interval
+        if (!std::isnan(last.spread)) {
+            spreadTime_ += last.spread * (time - last.time);
+            validTime_  += time - last.time;
+        }
+    }
+
+    Sample sample{time, stats.spread, stats.vwapBuy, stats.vwapSell, 0};
+    if (!std::isnan(sample.spread)) {
+        sample.bin = LogHistogram::binOf(sample.spread);
+        spreads_.add(sample.bin);
+    }
+    samples_.push_back(sample);
+
+    // Continuous-time EWMA: the weight of the past decays by exp(-dt / window), with dt
+    // measured from the last update, so snapshots skipped for NaN depth still decay it
+    if (!std::isnan(stats.bidDepth) && !std::isnan(stats.askDepth)) {
+        if (!ewmaSet_) {
+            bidEwma_ = stats.bidDepth;
+            askEwma_ = stats.askDepth;
+            ewmaSet_ = true;
+        } else {
+            double alpha = 1.0 - std::exp(-(time - lastEwmaTime_) / window_);
+            bidEwma_ += alpha * (stats.bidDepth - bidEwma_);
+            askEwma_ += alpha * (stats.askDepth - askEwma_);
+        }
+        lastEwmaTime_ = time;
+    }
+
+    evict(time - window_);
+}
+
+// Drops snapshots whose whole interval ended at or before `cutoff`. The oldest kept
+// snapshot may straddle the cutoff; values() clips that part of its interval.
+void RollingStats::evict(double cutoff) {
+    while (samples_.size() > 1 && samples_[1].time <= cutoff) {
+        const Sample& old = samples_.front();
+        if (!std::isnan(old.spread)) {
+            double held  = samples_[1].time - old.time;
+            spreadTime_ -= old.spread * held;
+            validTime_  -= held;
+            spreads_.remove(old.bin);
+        }
+        samples_.pop_front();
+        // Re-summing every window's worth of evictions keeps this O(1) amortized
+        if (++sinceResum_ >= std::max<size_t>(samples_.size(), 1024)) resum();
+    }
+}
+
+void RollingStats::resum() {
+    spreadTime_ = validTime_ = 0.0;
+    for (size_t i = 0; i + 1 < samples_.size(); i++) {
+        if (std::isnan(samples_[i].spread)) continue;
+        double held  = samples_[i + 1].time - samples_[i].time;
+        spreadTime_ += samples_[i].spread * held;
+        validTime_  += held;
+    }
+    sinceResum_ = 0;
+}
+
+std::array<double, RollingStats::COLUMNS> RollingStats::values() const {
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+    std::array<double, COLUMNS> v;
+    v.fill(NaN);
+    if (samples_.empty()) return v;
+
+    const Sample& first = samples_.front();
+    const Sample& last  = samples_.back();
+
+    // Clip the part of the oldest interval that lies before the window start
+    double spreadTime = spreadTime_, validTime = validTime_;
+    if (samples_.size() > 1 && !std::isnan(first.spread)) {
+        double clip = std::max(0.0, (last.time - window_) - first.time);
+        spreadTime -= first.spread * clip;
+        validTime  -= clip;
+    }
+    v[0] = validTime > 0.0 ? spreadTime / validTime : last.spread;
+
+    v[1] = spreads_.quantile(0.50);
+    v[2] = spreads_.quantile(0.90);
+    v[3] = spreads_.quantile(0.99);
+    if (ewmaSet_) {
+        v[4] = bidEwma_;
+        v[5] = askEwma_;
+    }
+    v[6] = (last.vwapBuy  - first.vwapBuy)  / first.vwapBuy  * 100.0;  // NaN propagates
+    v[7] = (last.vwapSell - first.vwapSell) / first.vwapSell * 100.0;
+    v[8] = static_cast<double>(samples_.size());
+    return v;
+}
+
+std::vector<std::string> rollingNames() {
+    return {"twa_spread", "spread_p50", "spread_p90", "spread_p99", "bid_depth_ewma",
+            "ask_depth_ewma", "vwap_buy_drift_pct", "vwap_sell_drift_pct", "window_snapshots"};
+}
@@ -0,0 +1,335 @@
+#include "orderbook/server.h"
+
+#include "orderbook/calc.h"
+#include "orderbook/cost.h"
+#include "orderbook/parse.h"
+#include "orderbook/profile.h"
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// ---- Protocol ----------------------------------------------------------------
+
+namespace {
+
+// Splits a request into at most MAX_FIELDS space-separated fields, in place
+struct RequestFields {
+    static constexpr size_t MAX_FIELDS = 8;
+    std::array<std::string_view, MAX_FIELDS> fields;
+    size_t count = 0;
+
+    explicit RequestFields(std::string_view line) {
+        while (count < MAX_FIELDS) {
+            size_t start = line.find_first_not_of(" \t\r");
+            if (start == std::string_view::npos) break;
+            line.remove_prefix(start);
+            size_t end = std::min(line.find_first_of(" \t\r"), line.size());
+            fields[count++] = line.substr(0, end);
+            line.remove_prefix(end);
+        }
+        if (line.find_first_not_of(" \t\r") != std::string_view::npos)
+            throw std::invalid_argument("Too many fields.");
+    }
+
+    // Field i of a request that must have exactly `expected` fields
+    std::string_view operator()(size_t i, size_t expected) const {
+        if (count != expected)
+            throw std::invalid_argument(std::string(fields[0]) + " takes " + std::to_string(expected - 1) +
+                                        " argument(s).");
+        return fields[i];
+    }
+};
+
+void appendValue(std::string& reply, double v) {
+    char digits[32];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), v, std::chars_format::general, 10);
+    reply.push_back(' ');
+    reply.append(digits, end);
+}
+
+double vwapOrNaN(const BookSide& side, double qty) {
+    CostPoint cost = costForQty(side, qty);
+    return cost.complete ? cost.vwap : std::numeric_limits<double>::quiet_NaN();
+}
+
+} // namespace
+
+void BookServer::load(const std::string& name, const std::string& path) {
+    auto entry = std::make_unique<ResidentBook>();
+    loader_(path, entry->book);
+    if (entry->book.bids.empty() || entry->book.asks.empty())
+        throw std::runtime_error("Book '" + path + "' has an empty side.");
+    toSoA(entry->book, entry->soa);
+    entry->source = path;
+    books_.insert_or_assign(name, std::move(entry));  // a failed reload keeps the old book
+}
+
+const ResidentBook& BookServer::find(std::string_view name) const {
+    auto it = books_.find(name);
+    if (it == books_.end()) throw std::invalid_argument("No book named '" + std::string(name) + "'.");
+    return *it->second;
+}
+
+bool BookServer::handle(std::string_view request, std::string& reply) {
+    requests_++;
+    size_t start = reply.size();
+    try {
+        RequestFields args(request);
+        if (args.count == 0) throw std::invalid_argument("Empty request.");
+        std::string_view command = args.fields[0];
+        reply += "OK";
+
+        if (command == "STATS") {
+            const SoABook& soa = find(args(1, 4)).soa;
+            double qty = parseDouble(args(3, 4), "qty");
+            Stats s;
+            calcTopOfBook(soa, parseDouble(args(2, 4), "depthPct", true), s);
+            s.vwapBuy  = vwapOrNaN(soa.asks, qty);
+            s.vwapSell = vwapOrNaN(soa.bids, qty);
+            for (double v : {s.bestBid, s.bestAsk, s.midPrice, s.spread, s.spreadPct,
+                             s.bidDepth, s.askDepth, s.vwapBuy, s.vwapSell})
+                appendValue(reply, v);
+        } else if (command == "SPREAD") {
+            const SoABook& soa = find(args(1, 2)).soa;
+            double bid = soa.bids.prices[0], ask = soa.asks.prices[0], mid = (bid + ask) / 2.0;
+            for (double v : {bid, ask, mid, ask - bid, (ask - bid) / mid * 100.0}) appendValue(reply, v);
+        } else if (command == "DEPTH") {
+            const SoABook& soa = find(args(1, 3)).soa;
+            Stats s;
+            calcTopOfBook(soa, parseDouble(args(2, 3), "depthPct", true), s);
+            appendValue(reply, s.bidDepth);
+            appendValue(reply, s.askDepth);
+        } else if (command == "VWAP") {
+            const SoABook& soa = find(args(1, 3)).soa;
+            double qty = parseDouble(args(2, 3), "qty");
+            appendValue(reply, vwapOrNaN(soa.asks, qty));
+            appendValue(reply, vwapOrNaN(soa.bids, qty));
+        } else if (command == "IMPACT") {
+            const SoABook& soa = find(args(1, 3)).soa;
+            for (double qty : parseDoubleList(args(2, 3), "qty")) {
+                appendValue(reply, vwapOrNaN(soa.asks, qty));
+                appendValue(reply, vwapOrNaN(soa.bids, qty));
+            }
+        } else if (command == "SLIPPAGE") {
+            const SoABook& soa = find(args(1, 3)).soa;
+            SlippagePoint p = calcSlippageCapacity(soa, {parseDouble(args(2, 3), "bps", true)})[0];
+            for (double v : {p.buyQty, p.buyVWAP, p.sellQty, p.sellVWAP}) appendValue(reply, v);
+        } else if (command == "LOAD") {
+            std::string name(args(1, 3));
+            load(name, std::string(args(2, 3)));
+            const SoABook& soa = find(name).soa;
+            appendValue(reply, static_cast<double>(soa.bids.size()));
+            appendValue(reply, static_cast<double>(soa.asks.size()));
+        } else if (command == "DROP") {
+            std::string_view name = args(1, 2);
+            auto it = books_.find(name);
+            if (it == books_.end()) throw std::invalid_argument("No book named '" + std::string(name) + "'.");
+            books_.erase(it);
+        } else if (command == "LIST") {
+            args(0, 1);
+            for (const auto& [name, entry] : books_) reply += " " + name;
+        } else if (command == "METRICS") {
+            args(0, 1);
+            size_t levels = 0;
+            for (const auto& [name, entry] : books_) levels += entry->soa.bids.size() + entry->soa.asks.size();
+            reply += " requests=" + std::to_string(requests_) + " errors=" + std::to_string(errors_) +
+                     " books=" + std::to_string(books_.size()) + " levels=" + std::to_string(levels);
+            if (profilingEnabled()) {
+                for (const StageTotals& stage : profileSummary().stages) {
+                    reply += " " + std::string(stageName(stage.stage)) + "_ms=";
+                    reply += std::to_string(stage.seconds * 1e3);
+                    reply += " " + std::string(stageName(stage.stage)) + "_calls=" + std::to_string(stage.calls);
+                }
+            }
+        } else if (command == "PING") {
+            args(0, 1);
+        } else if (command == "QUIT" || command == "SHUTDOWN") {
+            args(0, 1);
+            shutdown_ = shutdown_ || command == "SHUTDOWN";
+            reply += "\n";
+            return false;
+        } else {
+            throw std::invalid_argument("Unknown command: '" + std::string(command) + "'");
+        }
+    } catch (const std::exception& e) {
+        errors_++;
+        reply.resize(start);
+        reply += "ERR ";
+        reply += e.what();
+    }
+    reply += "\n";
+    return true;
+}
+
+// ---- Unix socket server ------------------------------------------------------
+
+namespace {
+
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path))
+        throw std::invalid_argument("Socket path too long: '" + path + "'");
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return addr;
+}
+
+} // namespace
+
+SocketServer::SocketServer(BookServer& books, const std::string& path) : books_(books), path_(path) {
+    sockaddr_un addr = socketAddress(path);
+
+    // A socket file left by a server that died is replaced; anything else is an error
+    struct stat st;
+    if (::lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) throw std::runtime_error("Not a socket: '" + path + "'");
+        ::unlink(path.c_str());
+    }
+
+    listener_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener_ < 0) throw std::runtime_error("Cannot create Unix socket.");
+    if (::bind(listener_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listener_, 64) != 0) {
+        ::close(listener_);
+        throw std::runtime_error("Cannot listen on '" + path + "': " + std::strerror(errno));
+    }
+}
+
+SocketServer::~SocketServer() {
+    for (Client& client : clients_) ::close(client.fd);
+    ::close(listener_);
+    ::unlink(path_.c_str());
+}
+
+void SocketServer::accept() {
+    for (;;) {
+        int fd = ::accept4(listener_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN: the backlog is drained
+        clients_.push_back({fd, {}, {}});
+    }
+}
+
+bool SocketServer::readFrom(Client& client) {
+    char buffer[16384];
+    for (;;) {
+        ssize_t n = ::recv(client.fd, buffer, sizeof(buffer), 0);
+        if (n == 0) return false;
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        client.input.append(buffer, static_cast<size_t>(n));
+
+        // Answer every complete line; a partial one waits for the rest of its bytes
+        size_t begin = 0;
+        for (size_t end; !client.closing && (end = client.input.find('\n', begin)) != std::string::npos;
+             begin = end + 1) {
+            if (!books_.handle(std::string_view(client.input).substr(begin, end - begin), client.output))
+                client.closing = true;
+        }
+        client.input.erase(0, client.closing ? client.input.size() : begin);
+
+        // No request comes close to this; a longer pending line is a runaway client
+        if (client.input.size() > MAX_LINE_BYTES) {
+            client.output += "ERR Request line longer than " + std::to_string(MAX_LINE_BYTES) + " bytes.\n";
+            client.input.clear();
+            client.closing = true;
+        }
+        if (client.closing || static_cast<size_t>(n) < sizeof(buffer)) return true;
+    }
+}
+
+bool SocketServer::writeTo(Client& client) {
+    size_t sent = 0;
+    while (sent < client.output.size()) {
+        ssize_t n = ::send(client.fd, client.output.data() + sent, client.output.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    client.output.erase(0, sent);
+    return true;
+}
+
+bool SocketServer::poll(int timeoutMs) {
+    std::vector<pollfd> fds;
+    fds.reserve(clients_.size() + 1);
+    fds.push_back({listener_, POLLIN, 0});
+    for (const Client& client : clients_)
+        fds.push_back({client.fd, static_cast<short>(client.output.empty() ? POLLIN : POLLIN | POLLOUT), 0});
+
+    if (::poll(fds.data(), fds.size(), timeoutMs) <= 0) return true;
+
+    // Clients accepted below are not in `fds`; they are polled from the next call on
+    size_t polled = clients_.size();
+    for (size_t i = 0; i < polled; i++) {
+        Client& client = clients_[i];
+        bool    open   = true;
+        if (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) open = readFrom(client);
+        open = writeTo(client) && open;
+        if (!open || (client.closing && client.output.empty())) {
+            ::close(client.fd);
+            client.fd = -1;
+        }
+    }
+    std::erase_if(clients_, [](const Client& client) { return client.fd < 0; });
+    if (fds[0].revents & POLLIN) accept();
+
+    if (books_.shutdownRequested()) {
+        for (Client& client : clients_) writeTo(client);  // best effort: flush the SHUTDOWN reply
+        return false;
+    }
+    return true;
+}
+
+// ---- Client ------------------------------------------------------------------
+
+void queryServer(const std::string& path, std::istream& requests, std::ostream& out) {
+    sockaddr_un addr = socketAddress(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        if (fd >= 0) ::close(fd);
+        throw std::runtime_error("Cannot connect to '" + path + "': " + std::strerror(errno));
+    }
+
+    // One request at a time: send a line, copy back its reply line
+    std::string line, reply;
+    char        buffer[16384];
+    while (std::getline(requests, line)) {
+        line += '\n';
+        for (size_t sent = 0; sent < line.size();) {
+            ssize_t n = ::send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                ::close(fd);
+                throw std::runtime_error("Server closed the connection.");
+            }
+            sent += static_cast<size_t>(n);
+        }
+        size_t end;
+        while ((end = reply.find('\n')) == std::string::npos) {
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) {
+                ::close(fd);
+                throw std::runtime_error("Server closed the connection.");
+            }
+            reply.append(buffer, static_cast<size_t>(n));
+        }
+        out.write(reply.data(), static_cast<std::streamsize>(end + 1));
+        reply.erase(0, end + 1);
+    }
+    out.flush();
+    ::close(fd);
+}
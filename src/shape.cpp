@@ -0,0 +1,140 @@
+#include "orderbook/shape.h"
+
+#include "orderbook/profile.h"
+
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+namespace {
+
+// Deepest price still inside a band of `pct` percent behind the best price of side S
+template <Side S>
+double bandLimit(double best, double pct) {
+    return best * (SideTraits<S>::isBid ? 1.0 - pct / 100.0 : 1.0 + pct / 100.0);
+}
+
+template <Side S>
+bool outsideBand(const Order& order, double limit) {
+    return SideTraits<S>::better(limit, order.price);
+}
+
+// Price a row ends up at once the shape's bucketing is applied
+template <Side S>
+double shapedPrice(double price, double bucket) {
+    if (bucket <= 0.0) return price;
+    double units = price / bucket;
+    return (SideTraits<S>::isBid ? std::floor(units + 1e-9) : std::ceil(units - 1e-9)) * bucket;
+}
+
+// Sorts one side best-first. With a top-N or band shape only the rows that can
+// survive are sorted: the band is one filter pass around the touch and top-N is an
+// nth_element selection, both linear, so a 10M-row side costs O(n + k log k).
+template <Side S>
+void sortSide(std::vector<Order>& orders, const BookShape& shape) {
+    BestFirst<S> better;
+    bool merging = shape.aggregate || shape.bucket > 0.0;
+
+    if (shape.bandPct > 0.0 && !orders.empty()) {
+        // Measured from the bucketed touch so no row of a kept bucket is dropped early
+        double best  = shapedPrice<S>(std::min_element(orders.begin(), orders.end(), better)->price, shape.bucket);
+        double limit = bandLimit<S>(best, shape.bandPct);
+        if (shape.bucket > 0.0) limit += SideTraits<S>::isBid ? -shape.bucket : shape.bucket;
+        std::erase_if(orders, [&](const Order& o) { return outsideBand<S>(o, limit); });
+    }
+
+    // Selects `keep` rows (plus ties with the cutoff, so a level is never split) and
+    // sorts them. Merging can fold several rows into one level, so the selection
+    // doubles until it covers topLevels distinct levels or the whole side.
+    for (size_t keep = shape.topLevels; keep > 0 && orders.size() > keep; keep *= 2) {
+        auto last = orders.begin() + (keep - 1);
+        std::nth_element(orders.begin(), last, orders.end(), better);
+        double cutoff = shapedPrice<S>(last->price, shape.bucket);
+        auto   tail   = std::partition(last + 1, orders.end(), [&](const Order& o) {
+            return shapedPrice<S>(o.price, shape.bucket) == cutoff;
+        });
+        std::sort(orders.begin(), tail, better);
+
+        size_t levels = merging ? 0 : keep;
+        for (auto it = orders.begin(); merging && it != tail && levels < shape.topLevels; ++it)
+            if (it == orders.begin() || shapedPrice<S>(it->price, shape.bucket) !=
+                                        shapedPrice<S>((it - 1)->price, shape.bucket))
+                levels++;
+        if (levels >= shape.topLevels) {
+            orders.erase(tail, orders.end());
+            return;
+        }
+    }
+    std::sort(orders.begin(), orders.end(), better);
+}
+
+// Exact top-N / band cut on a sorted side, after any merging
+template <Side S>
+void trimSide(std::vector<Order>& orders, const BookShape& shape) {
+    if (shape.bandPct > 0.0 && !orders.empty()) {
+        double limit = bandLimit<S>(orders[0].price, shape.bandPct);
+        orders.erase(std::find_if(orders.begin(), orders.end(),
+                                  [&](const Order& o) { return outsideBand<S>(o, limit); }),
+                     orders.end());
+    }
+    if (shape.topLevels > 0 && orders.size() > shape.topLevels) orders.resize(shape.topLevels);
+}
+
+// Snaps a sorted side to multiples of `bucket`. Bids round down and asks round up,
+// so a bucket never improves a price or crosses the book, and the order is kept.
+template <Side S>
+void bucketPrices(std::vector<Order>& orders, double bucket) {
+    for (auto& order : orders) order.price = shapedPrice<S>(order.price, bucket);
+    if (SideTraits<S>::isBid && !orders.empty() && orders.back().price <= 0.0)
+        throw std::runtime_error("Bucket " + std::to_string(bucket) + " rounds bid prices down to zero.");
+}
+
+} // namespace
+
+void mergeEqualPrices(std::vector<Order>& orders) {
+    if (orders.empty()) return;
+    size_t last = 0;
+    for (size_t i = 1; i < orders.size(); i++) {
+        if (orders[i].price == orders[last].price) orders[last].size += orders[i].size;
+        else                                       orders[++last] = orders[i];
+    }
+    orders.resize(last + 1);
+}
+
+void shapeBook(Orderbook& book, const BookShape& shape) {
+    if (shape.bucket > 0.0) {
+        bucketPrices<Side::BID>(book.bids, shape.bucket);
+        bucketPrices<Side::ASK>(book.asks, shape.bucket);
+    }
+    if (shape.aggregate || shape.bucket > 0.0) {
+        mergeEqualPrices(book.bids);
+        mergeEqualPrices(book.asks);
+    }
+    trimSide<Side::BID>(book.bids, shape);
+    trimSide<Side::ASK>(book.asks, shape);
+}
+
+void validateBook(const Orderbook& book) {
+    if (book.bids.empty()) throw std::runtime_error("No bids found in file.");
+    if (book.asks.empty()) throw std::runtime_error("No asks found in file.");
+
+    // Crossed book means the data is corrupt
+    if (book.bids[0].price >= book.asks[0].price)
+        throw std::runtime_error(
+            "Crossed book: best bid (" + std::to_string(book.bids[0].price) +
+            ") >= best ask ("          + std::to_string(book.asks[0].price) + ")."
+        );
+}
+
+void finalizeBook(Orderbook& book, const BookShape& shape) {
+    ProfileScope scope(Stage::SORT);
+    if (book.bids.empty()) throw std::runtime_error("No bids found in file.");
+    if (book.asks.empty()) throw std::runtime_error("No asks found in file.");
+
+    sortSide<Side::BID>(book.bids, shape);
+    sortSide<Side::ASK>(book.asks, shape);
+
+    shapeBook(book, shape);
+    validateBook(book);
+}
@@ -0,0 +1,200 @@
+#include "orderbook/simd.h"
+
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Each kernel set implements the masked depth sum and the best-first fill walk.
+// The fill walk consumes whole blocks of levels with vector math while the block
+// total is still below the remaining quantity, then finishes the partial block scalar.
+
+namespace {
+
+double depthScalar(const double* prices, const double* sizes, size_t n,
+                   double minPrice, double maxPrice) {
+    double total = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        bool inside = prices[i] >= minPrice && prices[i] <= maxPrice;
+        total += inside ? sizes[i] : 0.0;
+    }
+    return total;
+}
+
+double fillScalar(const double* prices, const double* sizes, size_t n,
+                  double targetQty, double& remaining) {
+    double notional = 0.0;
+    remaining = targetQty;
+    for (size_t i = 0; i < n && remaining > 0.0; i++) {
+        double filled = std::min(remaining, sizes[i]);
+        notional     += filled * prices[i];
+        remaining    -= filled;
+    }
+    return notional;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("avx2")))
+double hsumAVX2(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+__attribute__((target("avx2")))
+double depthAVX2(const double* prices, const double* sizes, size_t n,
+                 double minPrice, double maxPrice) {
+    const __m256d lo = _mm256_set1_pd(minPrice);
+    const __m256d hi = _mm256_set1_pd(maxPrice);
+    __m256d acc = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d p    = _mm256_loadu_pd(prices + i);
+        __m256d mask = _mm256_and_pd(_mm256_cmp_pd(p, lo, _CMP_GE_OQ), _mm256_cmp_pd(p, hi, _CMP_LE_OQ));
+        acc = _mm256_add_pd(acc, _mm256_and_pd(mask, _mm256_loadu_pd(sizes + i)));
+    }
+    return hsumAVX2(acc) + depthScalar(prices + i, sizes + i, n - i, minPrice, maxPrice);
+}
+
+__attribute__((target("avx2,fma")))
+double fillAVX2(const double* prices, const double* sizes, size_t n,
+                double targetQty, double& remaining) {
+    double notional = 0.0;
+    remaining = targetQty;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d s = _mm256_loadu_pd(sizes + i);
+        double blockQty = hsumAVX2(s);
+        if (blockQty >= remaining) break;
+        notional  += hsumAVX2(_mm256_mul_pd(s, _mm256_loadu_pd(prices + i)));
+        remaining -= blockQty;
+    }
+    double tailRemaining = 0.0;
+    notional += fillScalar(prices + i, sizes + i, n - i, remaining, tailRemaining);
+    remaining = tailRemaining;
+    return notional;
+}
+
+__attribute__((target("avx512f")))
+double depthAVX512(const double* prices, const double* sizes, size_t n,
+                   double minPrice, double maxPrice) {
+    const __m512d lo = _mm512_set1_pd(minPrice);
+    const __m512d hi = _mm512_set1_pd(maxPrice);
+    __m512d acc = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d   p    = _mm512_loadu_pd(prices + i);
+        __mmask8  mask = _mm512_cmp_pd_mask(p, lo, _CMP_GE_OQ) & _mm512_cmp_pd_mask(p, hi, _CMP_LE_OQ);
+        acc = _mm512_mask_add_pd(acc, mask, acc, _mm512_loadu_pd(sizes + i));
+    }
+    return _mm512_reduce_add_pd(acc) + depthScalar(prices + i, sizes + i, n - i, minPrice, maxPrice);
+}
+
+__attribute__((target("avx512f")))
+double fillAVX512(const double* prices, const double* sizes, size_t n,
+                  double targetQty, double& remaining) {
+    double notional = 0.0;
+    remaining = targetQty;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d s = _mm512_loadu_pd(sizes + i);
+        double blockQty = _mm512_reduce_add_pd(s);
+        if (blockQty >= remaining) break;
+        notional  += _mm512_reduce_add_pd(_mm512_mul_pd(s, _mm512_loadu_pd(prices + i)));
+        remaining -= blockQty;
+    }
+    double tailRemaining = 0.0;
+    notional += fillScalar(prices + i, sizes + i, n - i, remaining, tailRemaining);
+    remaining = tailRemaining;
+    return notional;
+}
+
+#elif defined(__aarch64__)
+
+double depthNEON(const double* prices, const double* sizes, size_t n,
+                 double minPrice, double maxPrice) {
+    const float64x2_t lo = vdupq_n_f64(minPrice);
+    const float64x2_t hi = vdupq_n_f64(maxPrice);
+    float64x2_t acc = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t p    = vld1q_f64(prices + i);
+        uint64x2_t  mask = vandq_u64(vcgeq_f64(p, lo), vcleq_f64(p, hi));
+        float64x2_t s    = vreinterpretq_f64_u64(vandq_u64(mask, vreinterpretq_u64_f64(vld1q_f64(sizes + i))));
+        acc = vaddq_f64(acc, s);
+    }
+    return vaddvq_f64(acc) + depthScalar(prices + i, sizes + i, n - i, minPrice, maxPrice);
+}
+
+double fillNEON(const double* prices, const double* sizes, size_t n,
+                double targetQty, double& remaining) {
+    double notional = 0.0;
+    remaining = targetQty;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float64x2_t s0 = vld1q_f64(sizes + i), s1 = vld1q_f64(sizes + i + 2);
+        double blockQty = vaddvq_f64(vaddq_f64(s0, s1));
+        if (blockQty >= remaining) break;
+        float64x2_t n0 = vmulq_f64(s0, vld1q_f64(prices + i));
+        float64x2_t n1 = vmulq_f64(s1, vld1q_f64(prices + i + 2));
+        notional  += vaddvq_f64(vaddq_f64(n0, n1));
+        remaining -= blockQty;
+    }
+    double tailRemaining = 0.0;
+    notional += fillScalar(prices + i, sizes + i, n - i, remaining, tailRemaining);
+    remaining = tailRemaining;
+    return notional;
+}
+
+#endif
+
+} // namespace
+
+const std::vector<SimdKernels>& availableKernels() {
+    static const std::vector<SimdKernels> kernels = [] {
+        std::vector<SimdKernels> list;
+#if defined(__x86_64__)
+        if (__builtin_cpu_supports("avx512f"))
+            list.push_back({"avx512", depthAVX512, fillAVX512});
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            list.push_back({"avx2", depthAVX2, fillAVX2});
+#elif defined(__aarch64__)
+        list.push_back({"neon", depthNEON, fillNEON}); // NEON is mandatory on AArch64
+#endif
+        list.push_back({"scalar", depthScalar, fillScalar});
+        return list;
+    }();
+    return kernels;
+}
+
+namespace {
+
+const SimdKernels*& activeKernelsSlot() {
+    static const SimdKernels* active = &availableKernels().front();
+    return active;
+}
+
+} // namespace
+
+const SimdKernels& activeKernels() { return *activeKernelsSlot(); }
+
+void selectKernels(std::string_view name) {
+    const auto& kernels = availableKernels();
+    if (name == "auto") {
+        activeKernelsSlot() = &kernels.front();
+        return;
+    }
+    for (const auto& k : kernels)
+        if (name == k.name) {
+            activeKernelsSlot() = &k;
+            return;
+        }
+    throw std::invalid_argument("Kernel set not available on this CPU: '" + std::string(name) + "'");
+}
@@ -0,0 +1,112 @@
+#include "orderbook/stream.h"
+
+#include "orderbook/calc.h"
+#include "orderbook/parse.h"
+#include "orderbook/profile.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <string_view>
+#include <string>
+#include <stdexcept>
+
+namespace {
+
+// A label that is entirely a number is the snapshot's time; anything else falls back
+// to the snapshot's ordinal
+template <typename T>
+T labelTime(const std::string& label, size_t ordinal) {
+    T time{};
+    const char* end = label.data() + label.size();
+    auto [parsed, ec] = std::from_chars(label.data(), end, time);
+    return ec == std::errc() && parsed == end && !label.empty() ? time : static_cast<T>(ordinal);
+}
+
+} // namespace
+
+size_t streamSnapshots(std::istream& in, RecordWriter& out, double depthPct, double targetQty,
+                       const BookShape& shape, RollingStats* rolling, HistoryWriter* history) {
+    std::string line;
+    if (!std::getline(in, line)) throw std::runtime_error("Empty input stream.");
+    int lineNumber = 1;
+
+    std::string_view header = trimView(line);
+    bool timestamped = header.size() >= 9 && header.substr(0, 9) == "timestamp";
+
+    Orderbook   book;
+    SoABook     soa;
+    std::string label;
+    size_t      emitted = 0;
+    int         lastRow = 0;  // line number of the current snapshot's last row
+
+    auto flush = [&]() {
+        if (book.bids.empty() && book.asks.empty()) return;
+        std::string name = label.empty() ? std::to_string(emitted + 1) : label;
+        try {
+            finalizeBook(book, shape);
+        } catch (const std::exception& e) {
+            throw std::runtime_error("Snapshot '" + name + "' (ending line " +
+                                     std::to_string(lastRow) + "): " + e.what());
+        }
+        toSoA(book, soa);
+        Stats stats = calcStatsNoThrow(soa, depthPct, targetQty);
+        if (history) history->append(labelTime<int64_t>(label, emitted + 1), book, stats);
+        if (rolling) {
+            rolling->add(labelTime<double>(label, emitted + 1), stats);
+
+            std::array<double, 9 + RollingStats::COLUMNS> values;
+            auto head = statsValues(stats);
+            auto tail = rolling->values();
+            std::copy(tail.begin(), tail.end(), std::copy(head.begin(), head.end(), values.begin()));
+            out.row(name, values);
+        } else {
+            out.row(name, statsValues(stats));
+        }
+        book.bids.clear();
+        book.asks.clear();
+        emitted++;
+    };
+
+    std::vector<std::string> columns = metricNames();
+    if (rolling) {
+        std::vector<std::string> extra = rollingNames();
+        columns.insert(columns.end(), extra.begin(), extra.end());
+    }
+    out.header("snapshot", columns, false);
+    for (;;) {
+        {
+            ProfileScope scope(Stage::READ);
+            if (!std::getline(in, line)) break;
+        }
+        lineNumber++;
+        std::string_view row = trimView(line);
+        if (row.empty()) continue;
+
+        if (!timestamped && row.front() == '#') {
+            flush();
+            label = trimView(row.substr(1));
+            continue;
+        }
+
+        if (timestamped) {
+            std::string_view timestamp = trimView(nextField(row));
+            if (timestamp.empty())
+                throw std::invalid_argument(
+                    "Line " + std::to_string(lineNumber) + " has empty fields."
+                );
+            if (timestamp != label) {
+                flush();
+                label = timestamp;
+            }
+        }
+
+        ProfileScope scope(Stage::PARSE);
+        Order order = parseRow(row, lineNumber);
+        if (order.side == Side::BID) book.bids.push_back(order);
+        else                         book.asks.push_back(order);
+        lastRow = lineNumber;
+    }
+    flush();
+    return emitted;
+}